@@ -30,6 +30,7 @@ SynchDisk::SynchDisk()
     semaphore = new Semaphore("synch disk", 0);
     lock = new Lock("synch disk lock");
     disk = new Disk(this);
+    latency = kernel->stats->RegisterHistogram("diskLatency");
 }
 
 //----------------------------------------------------------------------
@@ -57,10 +58,13 @@ SynchDisk::~SynchDisk()
 void
 SynchDisk::ReadSector(int sectorNumber, char* data)
 {
+    long long start = kernel->stats->totalTicks;
+
     lock->Acquire();			// only one disk I/O at a time
     disk->ReadRequest(sectorNumber, data);
     semaphore->P();			// wait for interrupt
     lock->Release();
+    latency->Record(kernel->stats->totalTicks - start);
 }
 
 //----------------------------------------------------------------------
@@ -75,10 +79,13 @@ SynchDisk::ReadSector(int sectorNumber, char* data)
 void
 SynchDisk::WriteSector(int sectorNumber, char* data)
 {
+    long long start = kernel->stats->totalTicks;
+
     lock->Acquire();			// only one disk I/O at a time
     disk->WriteRequest(sectorNumber, data);
     semaphore->P();			// wait for interrupt
     lock->Release();
+    latency->Record(kernel->stats->totalTicks - start);
 }
 
 //----------------------------------------------------------------------
@@ -14,6 +14,7 @@
 #include "disk.h"
 #include "synch.h"
 #include "callback.h"
+#include "stats.h"
 
 // The following class defines a "synchronous" disk abstraction.
 // As with other I/O devices, the raw physical disk is an asynchronous device --
@@ -50,6 +51,8 @@ class SynchDisk : public CallBackObj {
 					// with the interrupt handler
     Lock *lock;		  		// Only one read/write request
 					// can be sent to the disk at a time
+    StatHistogram *latency;		// ticks from each request until
+					// it is done, including queueing
 };
 
 #endif // SYNCHDISK_H
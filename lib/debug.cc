@@ -18,28 +18,31 @@
 //
 //	If the flag is "+", we enable all DEBUG messages.
 //
+//	The flags are turned into a bitmask once, here, so that checking
+//	a flag is cheap.
+//
 // 	"flagList" is a string of characters for whose DEBUG messages are 
 //		to be enabled.
 //----------------------------------------------------------------------
 
 Debug::Debug(char *flagList)
 {
-    enableFlags = flagList;
-}
-
-
-//----------------------------------------------------------------------
-// Debug::IsEnabled
-//      Return TRUE if DEBUG messages with "flag" are to be printed.
-//----------------------------------------------------------------------
+    unsigned char f;
 
-bool
-Debug::IsEnabled(char flag)
-{
-    if (enableFlags != NULL) {
-	return ((strchr(enableFlags, flag) != 0) 
-		|| (strchr(enableFlags, '+') != 0));
-    } else {
-    	return FALSE;
+    for (int i = 0; i < 256 / 32; i++) {
+	enableMask[i] = 0;
+    }
+    if (flagList == NULL) {
+	return;
+    }
+    if (strchr(flagList, dbgAll) != NULL) {
+	for (int i = 0; i < 256 / 32; i++) {
+	    enableMask[i] = ~0U;
+	}
+	return;
+    }
+    for (; *flagList != '\0'; flagList++) {
+	f = (unsigned char) *flagList;
+	enableMask[f >> 5] |= (1U << (f & 31));
     }
 }
@@ -6,6 +6,13 @@
 //	passed to Nachos (-d).  You are encouraged to add your own
 //	debugging flags.  Please.... 
 //
+//	Checking a flag is a single bit test, since DEBUG is used in 
+//	routines that run on every simulated instruction.  Categories
+//	can also be compiled out entirely, by defining DEBUG_STRIP to
+//	the flags to leave out, eg, -DDEBUG_STRIP=\"mi\", or \"+\" for
+//	all of them.  With optimization on, their DEBUG statements then
+//	generate no code at all.
+//
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
 // of liability and disclaimer of warranty provisions.
@@ -30,14 +37,30 @@ const char dbgAddr = 'a'; 		// address spaces
 const char dbgNet = 'n'; 		// network emulation
 const char dbgSys = 'u';                // systemcall
 
+// DebugCompiledIn is TRUE unless a flag's DEBUG statements have been 
+// compiled out.  Since DEBUG_STRIP and the flags are constants, the 
+// compiler evaluates it at compile time.
+
+#ifdef DEBUG_STRIP
+#define DebugCompiledIn(flag) \
+    (strchr(DEBUG_STRIP, (flag)) == NULL && strchr(DEBUG_STRIP, dbgAll) == NULL)
+#else
+#define DebugCompiledIn(flag) TRUE
+#endif
+
 class Debug {
   public:
     Debug(char *flagList);
 
-    bool IsEnabled(char flag);
+    bool IsEnabled(char flag) {
+	unsigned char f = (unsigned char) flag;
+	return DebugCompiledIn(flag) && ((enableMask[f >> 5] >> (f & 31)) & 1);
+    }
 
   private:
-    char *enableFlags;		// controls which DEBUG messages are printed
+    unsigned int enableMask[256 / 32];
+				// bit i is set iff DEBUG messages with
+				// flag i are printed
 };
 
 extern Debug *debug;
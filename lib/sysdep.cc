@@ -41,6 +41,9 @@
 
 #ifdef LINUX	 // at this point, linux doesn't support mprotect 
 #define NO_MPROT     
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <time.h>
 #endif
 #ifdef DOS	// neither does DOS
 #define NO_MPROT
@@ -160,6 +163,29 @@ UDelay(unsigned int useconds)
 
 }
 
+//----------------------------------------------------------------------
+// HostTime
+// 	Return the time on the host, in seconds, from some fixed point
+//	in the past.  Only differences between two times mean anything.
+//	Used to measure how long Nachos itself takes to do things.
+//----------------------------------------------------------------------
+
+double
+HostTime()
+{
+#ifdef LINUX
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+#else
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec / 1e6;
+#endif
+}
+
 //----------------------------------------------------------------------
 // Abort
 // 	Quit and drop core.
@@ -307,6 +333,180 @@ PollFile(int fd)
     return TRUE;
 }
 
+#ifdef LINUX
+static const int MaxPollerRetries = 100;	// interrupted epoll_waits
+#else
+// Without epoll, a poller is just the set of files being watched,
+// checked with a single select().  There is only one such set.
+
+static const int MaxPollerFds = 16;
+static int pollerFds[MaxPollerFds];
+static int numPollerFds = 0;
+#endif
+
+//----------------------------------------------------------------------
+// OpenPoller
+// 	Create a host I/O poller, to wait on several files at once.
+//	Return its descriptor.
+//----------------------------------------------------------------------
+
+int
+OpenPoller()
+{
+#ifdef LINUX
+    int poller = epoll_create(8);
+
+    ASSERT(poller >= 0);
+    return poller;
+#else
+    numPollerFds = 0;
+    return 0;
+#endif
+}
+
+//----------------------------------------------------------------------
+// ClosePoller
+// 	Release a host I/O poller.
+//----------------------------------------------------------------------
+
+void
+ClosePoller(int poller)
+{
+#ifdef LINUX
+    (void) Close(poller);
+#else
+    numPollerFds = 0;
+#endif
+}
+
+//----------------------------------------------------------------------
+// PollerWatch
+// 	Ask to be told (once) when "fd" next has characters to be read.
+//	Watching a file that is already watched re-arms it.
+//
+//	Returns FALSE if the file can't be watched (eg, it is a regular
+//	file, which is always ready to be read).
+//
+//	We don't look at errno to find out why epoll refused a file:
+//	lib/ is compiled with userprog/ on the include path, so
+//	<errno.h> would be the Nachos system call error codes.
+//----------------------------------------------------------------------
+
+bool
+PollerWatch(int poller, int fd)
+{
+#ifdef LINUX
+    struct epoll_event event;
+    struct stat status;
+
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+	return FALSE;			// always ready, until EOF
+    }
+    bzero(&event, sizeof(event));
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.fd = fd;
+    if (epoll_ctl(poller, EPOLL_CTL_MOD, fd, &event) == 0) {
+	return TRUE;
+    }
+    if (epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event) == 0) {
+	return TRUE;
+    }
+    return FALSE;			// some other file epoll can't watch
+#else
+    for (int i = 0; i < numPollerFds; i++) {
+	if (pollerFds[i] == fd) {
+	    return TRUE;
+	}
+    }
+    ASSERT(numPollerFds < MaxPollerFds);
+    pollerFds[numPollerFds++] = fd;
+    return TRUE;
+#endif
+}
+
+//----------------------------------------------------------------------
+// PollerIgnore
+// 	Stop watching "fd".
+//----------------------------------------------------------------------
+
+void
+PollerIgnore(int poller, int fd)
+{
+#ifdef LINUX
+    struct epoll_event event;	// ignored, but old kernels want one
+
+    (void) epoll_ctl(poller, EPOLL_CTL_DEL, fd, &event);
+#else
+    for (int i = 0; i < numPollerFds; i++) {
+	if (pollerFds[i] == fd) {
+	    pollerFds[i] = pollerFds[--numPollerFds];
+	    return;
+	}
+    }
+#endif
+}
+
+//----------------------------------------------------------------------
+// PollerWait
+// 	Find the watched files that have characters to be read.  Each
+//	one returned is no longer watched.
+//
+//	"readyFds" -- where to put the ready file descriptors
+//	"maxFds" -- the size of "readyFds"
+//	"block" -- if TRUE, wait until at least one file is ready;
+//		otherwise return immediately
+//
+//	Returns the number of ready files.
+//----------------------------------------------------------------------
+
+int
+PollerWait(int poller, int *readyFds, int maxFds, bool block)
+{
+#ifdef LINUX
+    struct epoll_event events[8];
+    int retVal, tries = 0;
+
+    if (maxFds > 8) {
+	maxFds = 8;
+    }
+    // a signal interrupts the wait; just wait again (a few times, so
+    // that a real error doesn't spin forever)
+    do {
+	retVal = epoll_wait(poller, events, maxFds, block ? -1 : 0);
+    } while (retVal < 0 && ++tries < MaxPollerRetries);
+    ASSERT(retVal >= 0);
+    for (int i = 0; i < retVal; i++) {
+	readyFds[i] = events[i].data.fd;
+    }
+    return retVal;
+#else
+    fd_set rfd;
+    int maxFd = 0, retVal, count = 0;
+    struct timeval pollTime;
+
+    FD_ZERO(&rfd);
+    for (int i = 0; i < numPollerFds; i++) {
+	FD_SET(pollerFds[i], &rfd);
+	if (pollerFds[i] >= maxFd) {
+	    maxFd = pollerFds[i] + 1;
+	}
+    }
+    pollTime.tv_sec = 0;
+    pollTime.tv_usec = 0;
+    retVal = select(maxFd, &rfd, NULL, NULL, block ? NULL : &pollTime);
+    if (retVal <= 0) {
+	return 0;
+    }
+    for (int i = numPollerFds - 1; i >= 0 && count < maxFds; i--) {
+	if (FD_ISSET(pollerFds[i], &rfd)) {
+	    readyFds[count++] = pollerFds[i];
+	    pollerFds[i] = pollerFds[--numPollerFds];
+	}
+    }
+    return count;
+#endif
+}
+
 //----------------------------------------------------------------------
 // OpenForWrite
 // 	Open a file for writing.  Create it if it doesn't exist; truncate it 
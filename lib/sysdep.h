@@ -23,6 +23,9 @@ extern void Exit(int exitCode);
 extern void Delay(int seconds);
 extern void UDelay(unsigned int usec);// rcgood - to avoid spinners.
 
+// Host (real, not simulated) time in seconds, for timing Nachos itself
+extern double HostTime();
+
 // Initialize system so that cleanUp routine is called when user hits ctl-C
 extern void CallOnUserAbort(void (*cleanup)(int));
 
@@ -39,6 +42,15 @@ extern void DeallocBoundedArray(char *p, int size);
 // If no characters in the file, return without waiting.
 extern bool PollFile(int fd);
 
+// Wait for any of a set of files to have characters to be read,
+// without polling each of them in turn.  A watched file reports
+// ready once, and must be watched again to hear about more input.
+extern int OpenPoller();
+extern void ClosePoller(int poller);
+extern bool PollerWatch(int poller, int fd);
+extern void PollerIgnore(int poller, int fd);
+extern int PollerWait(int poller, int *readyFds, int maxFds, bool block);
+
 // File operations: open/read/write/lseek/close, and check for error
 // For simulating the disk and the console devices.
 extern int OpenForWrite(char *name);
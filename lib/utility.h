@@ -24,6 +24,22 @@
 #define divRoundDown(n,s)  ((n) / (s))
 #define divRoundUp(n,s)    (((n) / (s)) + ((((n) % (s)) > 0) ? 1 : 0))
 
+// Find the index of the most significant 1 bit in "x" (which must be
+// non-zero), in constant time where the compiler knows how
+inline int
+highestBit(unsigned int x)
+{
+#ifdef __GNUC__
+    return 31 - __builtin_clz(x);
+#else
+    int bit = 0;
+    while (x >>= 1) {
+	bit++;
+    }
+    return bit;
+#endif
+}
+
 // This declares the type "VoidFunctionPtr" to be a "pointer to a
 // function taking an arbitrary pointer argument and returning nothing".  With
 // such a function pointer (say it is "func"), we can call it like this:
@@ -15,6 +15,7 @@
 #include "copyright.h"
 #include "console.h"
 #include "main.h"
+#include "replay.h"
 
 //----------------------------------------------------------------------
 // ConsoleInput::ConsoleInput
@@ -34,10 +35,11 @@ ConsoleInput::ConsoleInput(char *readFile, CallBackObj *toCall)
 
     // set up the stuff to emulate asynchronous interrupts
     callWhenAvail = toCall;
-    incoming = EOF;
+    numIncoming = 0;
+    nextIncoming = 0;
 
-    // start polling for incoming keystrokes
-    kernel->interrupt->Schedule(this, ConsoleTime, ConsoleReadInt);
+    // wait for incoming keystrokes
+    kernel->interrupt->WatchFile(readFileNo, this, ConsoleTime, ConsoleReadInt);
 }
 
 //----------------------------------------------------------------------
@@ -56,24 +58,43 @@ ConsoleInput::~ConsoleInput()
 // ConsoleInput::CallBack()
 // 	Simulator calls this when a character may be available to be
 //	read in from the simulated keyboard (eg, the user typed something).
+//	We only get here once the host has said the keyboard file has
+//	input, so there is no need to keep polling it.
 //
-//	First check to make sure character is available.
+//	First check to make sure character is available.  Whatever has
+//	been typed so far (up to ConsoleBlockSize chars) is moved in
+//	as one block.
 //	Then invoke the "callBack" registered by whoever wants the character.
 //----------------------------------------------------------------------
 
 void
 ConsoleInput::CallBack()
 {
-  char c;
+  ReplayLog *log = kernel->replayLog;
   int readCount;
 
-    ASSERT(incoming == EOF);
-    if (!PollFile(readFileNo)) { // nothing to be read
-        // schedule the next time to poll for a packet
-        kernel->interrupt->Schedule(this, ConsoleTime, ConsoleReadInt);
+    ASSERT(nextIncoming == numIncoming);
+    // try to read a block of characters; when replaying, they come
+    // from the log instead of the file
+    if (log != NULL && log->IsReplaying()) {
+	readCount = log->ReplayData(ReplayInput, incoming, ConsoleBlockSize);
+    } else {
+	readCount = -1;
+	if (PollFile(readFileNo)) {
+	    readCount = ReadPartial(readFileNo, incoming, ConsoleBlockSize);
+	    if (readCount < 0) {
+		readCount = 0;
+	    }
+	}
+	if (log != NULL) {
+	    log->Record(ReplayInput, readCount, incoming, max(readCount, 0));
+	}
+    }
+    if (readCount < 0) { // nothing to be read after all
+        // wait for the next keystroke
+        kernel->interrupt->WatchFile(readFileNo, this, ConsoleTime, 
+							ConsoleReadInt);
     } else { 
-    	// otherwise, try to read a character
-    	readCount = ReadPartial(readFileNo, &c, sizeof(char));
 	if (readCount == 0) {
 	   // this seems to happen at end of file, when the
 	   // console input is a regular file
@@ -82,12 +103,12 @@ ConsoleInput::CallBack()
 	   // just do nothing....
 	}
 	else {
-	  // save the character and notify the OS that
-	  // it is available
-	  ASSERT(readCount == sizeof(char));
-	  incoming = c;
-	  kernel->stats->numConsoleCharsRead++;
+	  // save the characters and notify the OS that
+	  // they are available
+	  kernel->stats->numConsoleCharsRead += readCount;
 	}
+	numIncoming = readCount;
+	nextIncoming = 0;
 	callWhenAvail->CallBack();
     }
 }
@@ -101,15 +122,52 @@ ConsoleInput::CallBack()
 char
 ConsoleInput::GetChar()
 {
-   char ch = incoming;
+   char ch;
 
-   if (incoming != EOF) {	// schedule when next char will arrive
-       kernel->interrupt->Schedule(this, ConsoleTime, ConsoleReadInt);
+   if (nextIncoming == numIncoming) {
+       return EOF;
+   }
+   ch = incoming[nextIncoming++];
+   if (nextIncoming == numIncoming) {	// wait for the next block
+       numIncoming = nextIncoming = 0;
+       kernel->interrupt->WatchFile(readFileNo, this, ConsoleTime, 
+							ConsoleReadInt);
    }
-   incoming = EOF;
    return ch;
 }
 
+//----------------------------------------------------------------------
+// ConsoleInput::GetBlock()
+// 	Copy characters out of the input buffer, if there are any there.
+//	Once the buffer has been drained, poll for the next block.
+//
+//	"into" -- where to put the characters
+//	"maxChars" -- the most characters the caller can take
+//
+//	Returns the number of characters copied, 0 if none are buffered.
+//----------------------------------------------------------------------
+
+int
+ConsoleInput::GetBlock(char *into, int maxChars)
+{
+   int count = numIncoming - nextIncoming;
+
+   if (count == 0) {
+       return 0;
+   }
+   if (count > maxChars) {
+       count = maxChars;
+   }
+   bcopy(incoming + nextIncoming, into, count);
+   nextIncoming += count;
+   if (nextIncoming == numIncoming) {	// wait for the next block
+       numIncoming = nextIncoming = 0;
+       kernel->interrupt->WatchFile(readFileNo, this, ConsoleTime, 
+							ConsoleReadInt);
+   }
+   return count;
+}
+
 
 
 //----------------------------------------------------------------------
@@ -130,6 +188,7 @@ ConsoleOutput::ConsoleOutput(char *writeFile, CallBackObj *toCall)
 
     callWhenDone = toCall;
     putBusy = FALSE;
+    numPut = 0;
 }
 
 //----------------------------------------------------------------------
@@ -153,7 +212,8 @@ void
 ConsoleOutput::CallBack()
 {
     putBusy = FALSE;
-    kernel->stats->numConsoleCharsWritten++;
+    kernel->stats->numConsoleCharsWritten += numPut;
+    numPut = 0;
     callWhenDone->CallBack();
 }
 
@@ -169,5 +229,23 @@ ConsoleOutput::PutChar(char ch)
     ASSERT(putBusy == FALSE);
     WriteFile(writeFileNo, &ch, sizeof(char));
     putBusy = TRUE;
+    numPut = 1;
+    kernel->interrupt->Schedule(this, ConsoleTime, ConsoleWriteInt);
+}
+
+//----------------------------------------------------------------------
+// ConsoleOutput::PutBlock()
+// 	Write a block of characters to the simulated display as a single
+//	transfer, schedule one interrupt to occur in the future, and return.
+//----------------------------------------------------------------------
+
+void
+ConsoleOutput::PutBlock(char *from, int numChars)
+{
+    ASSERT(putBusy == FALSE);
+    ASSERT(numChars > 0 && numChars <= ConsoleBlockSize);
+    WriteFile(writeFileNo, from, numChars);
+    putBusy = TRUE;
+    numPut = numChars;
     kernel->interrupt->Schedule(this, ConsoleTime, ConsoleWriteInt);
 }
@@ -31,6 +31,13 @@
 #include "utility.h"
 #include "callback.h"
 
+// The largest number of characters the simulated device moves in a
+// single transfer.  A block costs one interrupt, just like a single
+// character did, so callers that batch their I/O save a ConsoleTime
+// delay per character.
+
+const int ConsoleBlockSize = 128;
+
 // The following two classes define the input (and output) side of a 
 // hardware console device.  Input (and output) to the device is simulated 
 // by reading (and writing) to the UNIX file "readFile" (and "writeFile").
@@ -55,6 +62,13 @@ class ConsoleInput : public CallBackObj {
     				// "callWhenAvail" is called whenever there is 
 				// a char to be gotten
 
+    int GetBlock(char *into, int maxChars);
+				// Copy up to "maxChars" of the characters
+				// that arrived with the last interrupt.
+				// Returns 0 at EOF.
+    bool HasMore() { return nextIncoming < numIncoming; }
+				// Is part of the last block still here?
+
     void CallBack();		// Invoked when a character arrives
 				// from the keyboard.
 
@@ -62,9 +76,10 @@ class ConsoleInput : public CallBackObj {
     int readFileNo;			// UNIX file emulating the keyboard 
     CallBackObj *callWhenAvail;		// Interrupt handler to call when 
 					// there is a char to be read
-    char incoming;    			// Contains the character to be read,
-					// if there is one available. 
-					// Otherwise contains EOF.
+    char incoming[ConsoleBlockSize];	// Contains the characters to be
+					// read, if there are any available.
+    int numIncoming;			// How many chars arrived in "incoming"
+    int nextIncoming;			// Next char of "incoming" to hand out
 };
 
 class ConsoleOutput : public CallBackObj {
@@ -77,6 +92,12 @@ class ConsoleOutput : public CallBackObj {
 				// and return immediately.  "callWhenDone" 
 				// will called when the I/O completes. 
 
+    void PutBlock(char *from, int numChars);
+				// Write "numChars" (at most ConsoleBlockSize)
+				// to the display as one transfer; 
+				// "callWhenDone" is called once, when the
+				// whole block is out.
+
     void CallBack();		// Invoked when next character can be put
 				// out to the display.
 
@@ -86,6 +107,7 @@ class ConsoleOutput : public CallBackObj {
 					// the next char can be put 
     bool putBusy;    			// Is a PutChar operation in progress?
 					// If so, you can't do another one!
+    int numPut;				// How many chars are in flight
 };
 
 #endif // CONSOLE_H
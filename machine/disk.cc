@@ -180,7 +180,7 @@ Disk::TimeToSeek(int newSector, int *rotation)
     int oldTrack = lastSector / SectorsPerTrack;
     int seek = abs(newTrack - oldTrack) * SeekTime;
 				// how long will seek take?
-    int over = (kernel->stats->totalTicks + seek) % RotationTime; 
+    int over = (int) ((kernel->stats->totalTicks + seek) % RotationTime); 
 				// will we be in the middle of a sector when
 				// we finish the seek?
 
@@ -231,19 +231,21 @@ Disk::ComputeLatency(int newSector, bool writing)
 {
     int rotation;
     int seek = TimeToSeek(newSector, &rotation);
-    int timeAfter = kernel->stats->totalTicks + seek + rotation;
+    long long timeAfter = kernel->stats->totalTicks + seek + rotation;
 
 #ifndef NOTRACKBUF	// turn this on if you don't want the track buffer stuff
     // check if track buffer applies
     if ((writing == FALSE) && (seek == 0) 
 		&& (((timeAfter - bufferInit) / RotationTime) 
-	     		> ModuloDiff(newSector, bufferInit / RotationTime))) {
+	     		> ModuloDiff(newSector, 
+			    (int) ((bufferInit / RotationTime) % SectorsPerTrack)))) {
         DEBUG(dbgDisk, "Request latency = " << RotationTime);
 	return RotationTime; // time to transfer sector from the track buffer
     }
 #endif
 
-    rotation += ModuloDiff(newSector, timeAfter / RotationTime) * RotationTime;
+    rotation += ModuloDiff(newSector, 
+		(int) ((timeAfter / RotationTime) % SectorsPerTrack)) * RotationTime;
 
     DEBUG(dbgDisk, "Request latency = " << (seek + rotation + RotationTime));
     return(seek + rotation + RotationTime);
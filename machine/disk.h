@@ -81,7 +81,7 @@ class Disk : public CallBackObj {
     CallBackObj *callWhenDone;		// Invoke when any disk request finishes
     bool active;     			// Is a disk operation in progress?
     int lastSector;			// The previous disk request 
-    int bufferInit;			// When the track buffer started 
+    long long bufferInit;		// When the track buffer started 
 					// being loaded
 
     int TimeToSeek(int newSector, int *rotate); // time to get to the new track
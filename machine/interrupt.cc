@@ -23,43 +23,31 @@
 #include "copyright.h"
 #include "interrupt.h"
 #include "main.h"
+#include "replay.h"
 
 // String definitions for debugging messages
 
 static const char *intLevelNames[] = { "off", "on"};
 static const char *intTypeNames[] = { "timer", "disk", "console write", 
 			"console read", "network send", 
-			"network recv"};
+			"network recv", "alarm"};
 
-//----------------------------------------------------------------------
-// PendingInterrupt::PendingInterrupt
-// 	Initialize a hardware device interrupt that is to be scheduled 
-//	to occur in the near future.
-//
-//	"callOnInt" is the object to call when the interrupt occurs
-//	"time" is when (in simulated time) the interrupt is to occur
-//	"kind" is the hardware device that generated the interrupt
-//----------------------------------------------------------------------
-
-PendingInterrupt::PendingInterrupt(CallBackObj *callOnInt, 
-					int time, IntType kind)
-{
-    callOnInterrupt = callOnInt;
-    when = time;
-    type = kind;
-}
+const int InitialPending = 16;	// starting size of the pending heap
 
 //----------------------------------------------------------------------
-// PendingCompare
-//	Compare to interrupts based on which should occur first.
+// PendingBefore
+//	Return TRUE if interrupt "x" should occur before "y": it is
+//	due earlier, or it is due at the same time but was scheduled
+//	earlier.
 //----------------------------------------------------------------------
 
-static int
-PendingCompare (PendingInterrupt *x, PendingInterrupt *y)
+static bool
+PendingBefore(PendingInterrupt *x, PendingInterrupt *y)
 {
-    if (x->when < y->when) { return -1; }
-    else if (x->when > y->when) { return 1; }
-    else { return 0; }
+    if (x->when != y->when) {
+	return (x->when < y->when);
+    }
+    return ((int) (x->seq - y->seq) < 0);
 }
 
 //----------------------------------------------------------------------
@@ -72,10 +60,17 @@ PendingCompare (PendingInterrupt *x, PendingInterrupt *y)
 Interrupt::Interrupt()
 {
     level = IntOff;
-    pending = new SortedList<PendingInterrupt *>(PendingCompare);
+    pending = new PendingInterrupt[InitialPending];
+    numPending = 0;
+    maxPending = InitialPending;
+    nextSeq = 0;
     inHandler = FALSE;
     yieldOnReturn = FALSE;
     status = SystemMode;
+    poller = OpenPoller();
+    numWatched = 0;
+    nextPollTime = 0;
+    UpdateNextEvent();
 }
 
 //----------------------------------------------------------------------
@@ -85,10 +80,8 @@ Interrupt::Interrupt()
 
 Interrupt::~Interrupt()
 {
-    while (!pending->IsEmpty()) {
-	delete pending->RemoveFront();
-    }
-    delete pending;
+    delete [] pending;
+    ClosePoller(poller);
 }
 
 //----------------------------------------------------------------------
@@ -159,16 +152,24 @@ Interrupt::OneTick()
 	stats->userTicks += UserTick;
     }
     DEBUG(dbgInt, "== Tick " << stats->totalTicks << " ==");
+    if (stats->totalTicks >= stats->NextSnapshot()) {
+	stats->Snapshot();		// export the statistics
+	UpdateNextEvent();
+    }
 
 // check any pending interrupts are now ready to fire
     ChangeLevel(IntOn, IntOff);	// first, turn off interrupts
 				// (interrupt handlers run with
 				// interrupts disabled)
+    if (numWatched > 0 && stats->totalTicks >= nextPollTime) {
+	CheckWatchedFiles(FALSE);	// has any host input arrived?
+    }
     CheckIfDue(FALSE);		// check for pending interrupts
     ChangeLevel(IntOff, IntOn);	// re-enable interrupts
     if (yieldOnReturn) {	// if the timer device handler asked 
     				// for a context switch, ok to do it now
 	yieldOnReturn = FALSE;
+	UpdateNextEvent();
  	status = SystemMode;		// yield is a kernel routine
 	kernel->currentThread->Yield();
 	status = oldStatus;
@@ -191,6 +192,7 @@ Interrupt::YieldOnReturn()
 { 
     ASSERT(inHandler == TRUE);  
     yieldOnReturn = TRUE; 
+    UpdateNextEvent();
 }
 
 //----------------------------------------------------------------------
@@ -201,6 +203,10 @@ Interrupt::YieldOnReturn()
 //	on the ready queue, the only thing to do is to advance 
 //	simulated time until the next scheduled hardware interrupt.
 //
+//	If a device is waiting for host input, and nothing else is 
+//	scheduled, block the Nachos process until the input arrives,
+//	rather than spinning.
+//
 //	If there are no pending interrupts, stop.  There's nothing
 //	more for us to do.
 //----------------------------------------------------------------------
@@ -209,6 +215,10 @@ Interrupt::Idle()
 {
     DEBUG(dbgInt, "Machine idling; checking for interrupts.");
     status = IdleMode;
+    if (numWatched > 0 && 
+	(numPending == 0 || kernel->stats->totalTicks >= nextPollTime)) {
+	CheckWatchedFiles(numPending == 0);
+    }
     if (CheckIfDue(TRUE)) {	// check for any pending interrupts
 	status = SystemMode;
 	return;			// return in case there's now
@@ -217,8 +227,9 @@ Interrupt::Idle()
 
     // if there are no pending interrupts, and nothing is on the ready
     // queue, it is time to stop.   If the console or the network is 
-    // operating, there are *always* pending interrupts, so this code
-    // is not reached.  Instead, the halt must be invoked by the user program.
+    // operating, there are *always* pending interrupts or watched files,
+    // so this code is not reached.  Instead, the halt must be invoked 
+    // by the user program.
 
     DEBUG(dbgInt, "Machine idle.  No interrupts to do.");
     std::cout << "No threads ready or runnable, and no pending interrupts.\n";
@@ -243,7 +254,9 @@ Interrupt::Halt()
 // 	Arrange for the CPU to be interrupted when simulated time
 //	reaches "now + when".
 //
-//	Implementation: just put it on a sorted list.
+//	Implementation: add it to the heap, growing the heap if it is
+//	full.  The heap is only grown, never shrunk, so once Nachos has
+//	been running for a while scheduling doesn't allocate memory.
 //
 //	NOTE: the Nachos kernel should not call this routine directly.
 //	Instead, it is only called by the hardware device simulators.
@@ -256,13 +269,283 @@ Interrupt::Halt()
 void
 Interrupt::Schedule(CallBackObj *toCall, int fromNow, IntType type)
 {
-    int when = kernel->stats->totalTicks + fromNow;
-    PendingInterrupt *toOccur = new PendingInterrupt(toCall, when, type);
+    long long when = kernel->stats->totalTicks + fromNow;
+    PendingInterrupt *toOccur;
 
     DEBUG(dbgInt, "Scheduling interrupt handler the " << intTypeNames[type] << " at time = " << when);
     ASSERT(fromNow > 0);
 
-    pending->Insert(toOccur);
+    if (numPending == maxPending) {	// heap is full, so double it
+	PendingInterrupt *bigger = new PendingInterrupt[2 * maxPending];
+
+	for (int i = 0; i < numPending; i++) {
+	    bigger[i] = pending[i];
+	}
+	delete [] pending;
+	pending = bigger;
+	maxPending *= 2;
+    }
+    toOccur = &pending[numPending];
+    toOccur->callOnInterrupt = toCall;
+    toOccur->when = when;
+    toOccur->seq = nextSeq++;
+    toOccur->type = type;
+    numPending++;
+    SiftUp(numPending - 1);
+    UpdateNextEvent();
+}
+
+//----------------------------------------------------------------------
+// Interrupt::Cancel
+// 	Cancel the interrupts of a given type that are scheduled for a
+//	device, for instance when the device is reset.
+//
+//	Cancelling is much rarer than scheduling, so we just search
+//	the heap for the interrupts.
+//
+// Returns:
+//	TRUE, if any interrupts were cancelled
+// Params:
+//	"callTo" is the object the interrupts were to call
+//	"type" is the hardware device that scheduled them
+//----------------------------------------------------------------------
+
+bool
+Interrupt::Cancel(CallBackObj *callTo, IntType type)
+{
+    bool found = FALSE;
+    int i = 0;
+
+    while (i < numPending) {
+	if (pending[i].callOnInterrupt == callTo && pending[i].type == type) {
+	    DEBUG(dbgInt, "Cancelling interrupt handler the " << intTypeNames[type] << " at time = " << pending[i].when);
+	    RemovePending(i);	// moves another interrupt into slot i
+	    found = TRUE;
+	} else {
+	    i++;
+	}
+    }
+    return found;
+}
+
+//----------------------------------------------------------------------
+// Interrupt::SiftUp
+// 	Move pending[i] up the heap, until it is due no earlier than 
+//	its parent.
+//----------------------------------------------------------------------
+
+void
+Interrupt::SiftUp(int i)
+{
+    PendingInterrupt item = pending[i];
+    int parent;
+
+    while (i > 0) {
+	parent = (i - 1) / 2;
+	if (!PendingBefore(&item, &pending[parent])) {
+	    break;
+	}
+	pending[i] = pending[parent];
+	i = parent;
+    }
+    pending[i] = item;
+}
+
+//----------------------------------------------------------------------
+// Interrupt::SiftDown
+// 	Move pending[i] down the heap, until it is due no later than 
+//	either of its children.
+//----------------------------------------------------------------------
+
+void
+Interrupt::SiftDown(int i)
+{
+    PendingInterrupt item = pending[i];
+    int child;
+
+    for (;;) {
+	child = 2 * i + 1;
+	if (child >= numPending) {
+	    break;
+	}
+	if (child + 1 < numPending 
+		&& PendingBefore(&pending[child + 1], &pending[child])) {
+	    child++;			// the earlier of the two children
+	}
+	if (!PendingBefore(&pending[child], &item)) {
+	    break;
+	}
+	pending[i] = pending[child];
+	i = child;
+    }
+    pending[i] = item;
+}
+
+//----------------------------------------------------------------------
+// Interrupt::RemovePending
+// 	Take pending[i] out of the heap, by moving the last interrupt
+//	into its place and then restoring the heap order.
+//----------------------------------------------------------------------
+
+void
+Interrupt::RemovePending(int i)
+{
+    ASSERT(i >= 0 && i < numPending);
+    numPending--;
+    if (i < numPending) {
+	pending[i] = pending[numPending];
+	if (i > 0 && PendingBefore(&pending[i], &pending[(i - 1) / 2])) {
+	    SiftUp(i);
+	} else {
+	    SiftDown(i);
+	}
+    }
+    UpdateNextEvent();
+}
+
+//----------------------------------------------------------------------
+// Interrupt::UpdateNextEvent
+// 	Recompute when OneTick next has something to do besides 
+//	advancing the clock: fire the next pending interrupt, poll the
+//	watched files, yield on return from a handler, or export a 
+//	snapshot of the statistics.  Called whenever any of those change.
+//
+//	If we are tracing interrupts, OneTick prints every tick, so
+//	it must always be called.
+//----------------------------------------------------------------------
+
+void
+Interrupt::UpdateNextEvent()
+{
+    nextEventTime = TimeNever;
+    if (numPending > 0) {
+	nextEventTime = pending[0].when;
+    }
+    if (numWatched > 0 && nextPollTime < nextEventTime) {
+	nextEventTime = nextPollTime;
+    }
+    if (kernel->stats->NextSnapshot() < nextEventTime) {
+	nextEventTime = kernel->stats->NextSnapshot();
+    }
+    if (yieldOnReturn || debug->IsEnabled(dbgInt)) {
+	nextEventTime = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// Interrupt::WatchFile
+// 	Arrange for the CPU to be interrupted "delay" ticks after the
+//	host file "fd" has input to be read.  This is how a device
+//	waits for input, rather than scheduling an interrupt every so
+//	often to poll for it.
+//
+//	The file is watched once: the device must call WatchFile again
+//	after it has taken the input.
+//
+//	If the host can't watch the file (eg, a regular file, which 
+//	always has input until EOF), just schedule the interrupt.
+//	When replaying a log, the log says whether it could.
+//
+//	"fd" -- the host file to wait on
+//	"callTo" is the object to call when the interrupt occurs
+//	"delay" is how long after the input arrives the interrupt occurs
+//	"type" is the hardware device that generated the interrupt
+//----------------------------------------------------------------------
+
+void
+Interrupt::WatchFile(int fd, CallBackObj *callTo, int delay, IntType type)
+{
+    ReplayLog *log = kernel->replayLog;
+    bool alwaysReady;
+    int i, value;
+
+    DEBUG(dbgInt, "Watching file " << fd << " for the " << intTypeNames[type]);
+    if (log != NULL && log->IsReplaying()) {
+	alwaysReady = log->Replay(ReplayWatchReady, &value);
+    } else {
+	alwaysReady = !PollerWatch(poller, fd);
+	if (alwaysReady && log != NULL) {
+	    log->Record(ReplayWatchReady, type, NULL, 0);
+	}
+    }
+    if (alwaysReady) {
+	Schedule(callTo, delay, type);
+	return;
+    }
+    for (i = 0; i < numWatched; i++) {
+	if (watched[i].fd == fd) {
+	    break;
+	}
+    }
+    if (i == numWatched) {
+	ASSERT(numWatched < MaxWatchedFiles);
+	numWatched++;
+    }
+    watched[i].fd = fd;
+    watched[i].callOnReady = callTo;
+    watched[i].delay = delay;
+    watched[i].type = type;
+    nextPollTime = kernel->stats->totalTicks + ConsoleTime;
+    UpdateNextEvent();
+}
+
+//----------------------------------------------------------------------
+// Interrupt::CheckWatchedFiles
+// 	Ask the host which watched files have input, and schedule the
+//	interrupt for each of them.  To keep the host from being asked
+//	on every tick, this is only done once every ConsoleTime ticks
+//	while there is a thread running.
+//
+//	When replaying a log, the log says which files had input, and
+//	we never wait for the host.
+//
+// Returns:
+//	TRUE, if any interrupts were scheduled
+// Params:
+//	"block" -- if TRUE, wait until some file has input
+//----------------------------------------------------------------------
+
+bool
+Interrupt::CheckWatchedFiles(bool block)
+{
+    ReplayLog *log = kernel->replayLog;
+    int readyFds[MaxWatchedFiles];
+    int numReady, type;
+
+    ASSERT(level == IntOff);
+    if (log != NULL && log->IsReplaying()) {
+	numReady = 0;
+	while (numReady < MaxWatchedFiles
+			&& log->Replay(ReplayFileReady, &type)) {
+	    for (int i = 0; i < numWatched; i++) {
+		if (watched[i].type == type) {
+		    readyFds[numReady++] = watched[i].fd;
+		    break;
+		}
+	    }
+	}
+    } else {
+	if (block) {
+	    DEBUG(dbgInt, "Machine idle.  Waiting for host input.");
+	}
+	numReady = PollerWait(poller, readyFds, MaxWatchedFiles, block);
+    }
+    for (int r = 0; r < numReady; r++) {
+	for (int i = 0; i < numWatched; i++) {
+	    if (watched[i].fd == readyFds[r]) {
+		if (log != NULL && !log->IsReplaying()) {
+		    log->Record(ReplayFileReady, watched[i].type, NULL, 0);
+		}
+		Schedule(watched[i].callOnReady, watched[i].delay, 
+							watched[i].type);
+		watched[i] = watched[--numWatched];
+		break;
+	    }
+	}
+    }
+    nextPollTime = kernel->stats->totalTicks + ConsoleTime;
+    UpdateNextEvent();
+    return (numReady > 0);
 }
 
 //----------------------------------------------------------------------
@@ -280,7 +563,7 @@ Interrupt::Schedule(CallBackObj *toCall, int fromNow, IntType type)
 bool
 Interrupt::CheckIfDue(bool advanceClock)
 {
-    PendingInterrupt *next;
+    PendingInterrupt next;
     Statistics *stats = kernel->stats;
 
     ASSERT(level == IntOff);		// interrupts need to be disabled,
@@ -288,23 +571,26 @@ Interrupt::CheckIfDue(bool advanceClock)
     if (debug->IsEnabled(dbgInt)) {
 	DumpState();
     }
-    if (pending->IsEmpty()) {   	// no pending interrupts
+    if (numPending == 0) {   		// no pending interrupts
 	return FALSE;	
     }		
-    next = pending->Front();
-    if (next->when > stats->totalTicks) {
+    if (pending[0].when > stats->totalTicks) {
         if (!advanceClock) {		// not time yet
             return FALSE;
         }
         else {      		// advance the clock to next interrupt
-	    stats->idleTicks += (next->when - stats->totalTicks);
-	    stats->totalTicks = next->when;
+	    stats->idleTicks += (pending[0].when - stats->totalTicks);
+	    stats->totalTicks = pending[0].when;
 	    // UDelay(1000L); // rcgood - to stop nachos from spinning.
+	    if (stats->totalTicks >= stats->NextSnapshot()) {
+		stats->Snapshot();
+		UpdateNextEvent();
+	    }
 	}
     }
 
     DEBUG(dbgInt, "Invoking interrupt handler for the ");
-    DEBUG(dbgInt, intTypeNames[next->type] << " at time " << next->when);
+    DEBUG(dbgInt, intTypeNames[pending[0].type] << " at time " << pending[0].when);
 
     if (kernel->machine != NULL) {
     	kernel->machine->DelayedLoad(0, 0);
@@ -312,11 +598,11 @@ Interrupt::CheckIfDue(bool advanceClock)
 
     inHandler = TRUE;
     do {
-        next = pending->RemoveFront();    // pull interrupt off list
-        next->callOnInterrupt->CallBack();// call the interrupt handler
-	delete next;
-    } while (!pending->IsEmpty() 
-    		&& (pending->Front()->when <= stats->totalTicks));
+        next = pending[0];		// pull interrupt off the heap,
+	RemovePending(0);		// since the handler may schedule 
+					// more, and move the heap
+        next.callOnInterrupt->CallBack();// call the interrupt handler
+    } while (numPending > 0 && (pending[0].when <= stats->totalTicks));
     inHandler = FALSE;
     return TRUE;
 }
@@ -331,7 +617,7 @@ static void
 PrintPending (PendingInterrupt *pending)
 {
     std::cout << "Interrupt handler "<< intTypeNames[pending->type];
-    std::cout << ", scheduled at " << pending->when;
+    std::cout << ", scheduled at " << pending->when << "\n";
 }
 
 //----------------------------------------------------------------------
@@ -345,7 +631,13 @@ Interrupt::DumpState()
 {
     std::cout << "Time: " << kernel->stats->totalTicks;
     std::cout << ", interrupts " << intLevelNames[level] << "\n";
-    std::cout << "Pending interrupts:\n";
-    pending->Apply(PrintPending);
+    std::cout << "Pending interrupts (in heap order):\n";
+    for (int i = 0; i < numPending; i++) {
+	PrintPending(&pending[i]);
+    }
     std::cout << "\nEnd of pending interrupts\n";
+    for (int i = 0; i < numWatched; i++) {
+	std::cout << "Waiting on file " << watched[i].fd << " for the ";
+	std::cout << intTypeNames[watched[i].type] << "\n";
+    }
 }
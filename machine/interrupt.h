@@ -47,27 +47,48 @@ enum MachineStatus {IdleMode, SystemMode, UserMode};
 
 // IntType records which hardware device generated an interrupt.
 // In Nachos, we support a hardware timer device, a disk, a console
-// display and keyboard, and a network.
+// display and keyboard, and a network.  AlarmInt wakes threads
+// sleeping in Alarm::WaitUntil.
 enum IntType { TimerInt, DiskInt, ConsoleWriteInt, ConsoleReadInt, 
-			NetworkSendInt, NetworkRecvInt};
+			NetworkSendInt, NetworkRecvInt, AlarmInt};
 
 // The following class defines an interrupt that is scheduled
 // to occur in the future.  The internal data structures are
 // left public to make it simpler to manipulate.
+//
+// Pending interrupts are kept by value in a binary heap, ordered by
+// when they fire and then by when they were scheduled, so that
+// interrupts due at the same time fire in the order they were
+// scheduled.
 
 class PendingInterrupt {
   public:
-    PendingInterrupt(CallBackObj *callOnInt, int time, IntType kind);
-				// initialize an interrupt that will
-				// occur in the future
-
     CallBackObj *callOnInterrupt;// The object (in the hardware device
 				// emulator) to call when the interrupt occurs
     
-    int when;			// When the interrupt is supposed to fire
+    long long when;		// When the interrupt is supposed to fire
+    unsigned int seq;		// Order the interrupt was scheduled in
+    IntType type;		// for debugging
+};
+
+// The following class records a host file that a device wants to hear
+// about when it has input, instead of polling the file itself.  Once 
+// the file is ready, the device's interrupt is scheduled "delay" ticks 
+// later, and the file is no longer watched.
+
+class WatchedFile {
+  public:
+    int fd;			// host file to wait on
+    CallBackObj *callOnReady;	// the device to interrupt
+    int delay;			// how long the device takes to respond
     IntType type;		// for debugging
 };
 
+const int MaxWatchedFiles = 8;
+
+const long long TimeNever = 0x7fffffffffffffffLL;
+				// later than any simulated time
+
 // The following class defines the data structures for the simulation
 // of hardware interrupts.  We record whether interrupts are enabled
 // or disabled, and any hardware interrupts that are scheduled to occur
@@ -113,18 +134,43 @@ class Interrupt {
     				// Schedule an interrupt to occur
 				// at time "when".  This is called
     				// by the hardware device simulators.
+
+    bool Cancel(CallBackObj *callTo, IntType type);
+				// Cancel the interrupts of this type
+				// scheduled for "callTo"; return
+				// TRUE if there were any
+
+    void WatchFile(int fd, CallBackObj *callTo, int delay, IntType type);
+				// Schedule an interrupt to occur "delay"
+				// ticks after host file "fd" has 
+				// something to be read.
     
     void OneTick();       	// Advance simulated time
 
+    long long NextEventTime() { return nextEventTime; }
+				// Until this time, OneTick would do
+				// nothing but advance the clock, so
+				// the CPU may do that itself
+
   private:
     IntStatus level;		// are interrupts enabled or disabled?
-    SortedList<PendingInterrupt *> *pending;		
-    				// the list of interrupts scheduled
-				// to occur in the future
+    PendingInterrupt *pending;	// heap of the interrupts scheduled
+				// to occur in the future; pending[0]
+				// is the next one
+    int numPending;		// number of interrupts in the heap
+    int maxPending;		// size of the "pending" array
+    unsigned int nextSeq;	// seq of the next interrupt scheduled
     bool inHandler;		// TRUE if we are running an interrupt handler
     bool yieldOnReturn; 	// TRUE if we are to context switch
 				// on return from the interrupt handler
     MachineStatus status;	// idle, kernel mode, user mode
+    int poller;			// host poller for the watched files
+    WatchedFile watched[MaxWatchedFiles];
+				// files waiting for input
+    int numWatched;		// number of valid entries in "watched"
+    long long nextPollTime;	// when to next check the watched files,
+				// if we aren't idle
+    long long nextEventTime;	// when anything can next happen
 
     // these functions are internal to the interrupt simulation code
 
@@ -134,6 +180,15 @@ class Interrupt {
 
     void ChangeLevel(IntStatus old, 	// SetLevel, without advancing the
 			IntStatus now); // simulated time
+
+    void SiftUp(int i);		// Restore the heap order, after
+    void SiftDown(int i);	// pending[i] moves earlier or later
+    void RemovePending(int i);	// Take pending[i] out of the heap
+    void UpdateNextEvent();	// Recompute nextEventTime
+
+    bool CheckWatchedFiles(bool block);
+				// Schedule the interrupts for any watched
+				// files that have input
 };
 
 #endif // INTERRRUPT_H
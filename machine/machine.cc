@@ -122,7 +122,7 @@ Machine::RaiseException(ExceptionType which, int badVAddr)
 void Machine::Debugger()
 {
     char *buf = new char[80];
-    int num;
+    long long num;
     bool done = FALSE;
 
     kernel->interrupt->DumpState();
@@ -133,7 +133,7 @@ void Machine::Debugger()
       std::cout << kernel->stats->totalTicks << ">";
       // read one line of input (80 chars max)
       std::cin.get(buf, 80);
-      if (sscanf(buf, "%d", &num) == 1) {
+      if (sscanf(buf, "%lld", &num) == 1) {
 	runUntilTime = num;
 	done = TRUE;
       }
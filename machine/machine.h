@@ -175,7 +175,7 @@ class Machine {
 
     bool singleStep;		// drop back into the debugger after each
 				// simulated instruction
-    int runUntilTime;		// drop back into the debugger when simulated
+    long long runUntilTime;	// drop back into the debugger when simulated
 				// time reaches this value
 
     friend class Interrupt;		// calls DelayedLoad()    
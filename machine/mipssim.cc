@@ -21,8 +21,12 @@
 #include "machine.h"
 #include "mipssim.h"
 #include "main.h"
+#include "userprofile.h"
+#include "trace.h"
 
 static void Mult(int a, int b, bool signedArith, int* hiPtr, int* loPtr);
+static TraceAccess MemoryAccess(int opCode);
+static bool IsTransfer(int opCode, bool *conditional);
 
 // The following class defines an instruction, represented in both
 // 	undecoded binary form
@@ -51,21 +55,35 @@ class Instruction {
 //
 //	This routine is re-entrant, in that it can be called multiple
 //	times concurrently -- one for each thread executing user code.
+//
+//	Until the next interrupt is due, the clock is advanced here
+//	rather than by calling OneTick after every instruction.
 //----------------------------------------------------------------------
 
 void
 Machine::Run()
 {
     Instruction *instr = new Instruction;  // storage for decoded instruction
+    Interrupt *interrupt = kernel->interrupt;
+    Statistics *stats = kernel->stats;
+    UserProfiler *profiler = kernel->userProfiler;
 
     if (debug->IsEnabled('m')) {
         std::cout << "Starting program in thread: " << kernel->currentThread->getName();
 	std::cout << ", at time: " << kernel->stats->totalTicks << "\n";
     }
-    kernel->interrupt->setStatus(UserMode);
+    interrupt->setStatus(UserMode);
     for (;;) {
         OneInstruction(instr);
-	kernel->interrupt->OneTick();
+	if (profiler != NULL) {
+	    profiler->Tick();
+	}
+	if (stats->totalTicks + UserTick < interrupt->NextEventTime()) {
+	    stats->totalTicks += UserTick;	// nothing can happen yet
+	    stats->userTicks += UserTick;
+	} else {
+	    interrupt->OneTick();
+	}
 	if (singleStep && (runUntilTime <= kernel->stats->totalTicks))
 	  Debugger();
     }
@@ -135,6 +153,16 @@ Machine::OneInstruction(Instruction *instr)
     instr->value = raw;
     instr->Decode();
 
+    if (kernel->traceWriter != NULL) {	// record it before it runs
+	TraceAccess access = MemoryAccess(instr->opCode);
+
+	kernel->traceWriter->Record(registers[PCReg], instr->opCode, access,
+		(access == TraceNone) ? 0 : registers[instr->rs] + instr->extra);
+    }
+    if (kernel->instrCounter != NULL) {
+	kernel->instrCounter->Count(registers[PCReg], instr->opCode);
+    }
+
     if (debug->IsEnabled('m')) {
         struct OpString *str = &opStrings[instr->opCode];
 	char buf[80];
@@ -690,6 +718,14 @@ Machine::OneInstruction(Instruction *instr)
     
     // Now we have successfully executed the instruction.
     
+    // Count the branch or jump, if this was one.
+    bool conditional;
+    if (kernel->instrCounter != NULL
+		&& IsTransfer(instr->opCode, &conditional)) {
+	kernel->instrCounter->Transfer(registers[PCReg], conditional,
+			pcAfter != registers[NextPCReg] + 4, pcAfter);
+    }
+
     // Do any delayed load operation
     DelayedLoad(nextLoadReg, nextLoadValue);
     
@@ -700,6 +736,84 @@ Machine::OneInstruction(Instruction *instr)
     registers[NextPCReg] = pcAfter;
 }
 
+//----------------------------------------------------------------------
+// MemoryAccess
+// 	Return whether an instruction loads from memory, stores to
+//	memory, or neither, for the instruction trace.  Loads and stores
+//	all access the address in register "rs" plus the offset.
+//----------------------------------------------------------------------
+
+static TraceAccess
+MemoryAccess(int opCode)
+{
+    switch (opCode) {
+      case OP_LB:
+      case OP_LBU:
+      case OP_LH:
+      case OP_LHU:
+      case OP_LW:
+      case OP_LWL:
+      case OP_LWR:
+	return TraceLoad;
+      case OP_SB:
+      case OP_SH:
+      case OP_SW:
+      case OP_SWL:
+      case OP_SWR:
+	return TraceStore;
+      default:
+	return TraceNone;
+    }
+}
+
+//----------------------------------------------------------------------
+// IsTransfer
+// 	Return whether an instruction is a branch or a jump, for the
+//	instruction counters, and set "conditional" if it is a
+//	conditional branch.
+//----------------------------------------------------------------------
+
+static bool
+IsTransfer(int opCode, bool *conditional)
+{
+    switch (opCode) {
+      case OP_BEQ:
+      case OP_BGEZ:
+      case OP_BGEZAL:
+      case OP_BGTZ:
+      case OP_BLEZ:
+      case OP_BLTZ:
+      case OP_BLTZAL:
+      case OP_BNE:
+	*conditional = TRUE;
+	return TRUE;
+      case OP_J:
+      case OP_JAL:
+      case OP_JALR:
+      case OP_JR:
+	*conditional = FALSE;
+	return TRUE;
+      default:
+	return FALSE;
+    }
+}
+
+//----------------------------------------------------------------------
+// OpCodeName
+// 	Copy the mnemonic of an opcode, such as "ADDIU", into "name",
+//	for reports on instruction traces.
+//----------------------------------------------------------------------
+
+void
+OpCodeName(int opCode, char *name)
+{
+    ASSERT(opCode >= 0 && opCode <= MaxOpcode);
+    const char *format = opStrings[opCode].format;
+    int length = strcspn(format, " ");
+
+    sprintf(name, "%.*s", length, format);
+}
+
 //----------------------------------------------------------------------
 // Machine::DelayedLoad
 // 	Simulate effects of a delayed load.
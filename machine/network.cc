@@ -11,6 +11,7 @@
 #include "copyright.h"
 #include "network.h"
 #include "main.h"
+#include "replay.h"
 
 //-----------------------------------------------------------------------
 // NetworkInput::NetworkInput
@@ -31,8 +32,8 @@ NetworkInput::NetworkInput(CallBackObj *toCall)
     AssignNameToSocket(sockName, sock);		 // Bind socket to a filename 
 						 // in the current directory.
 
-    // start polling for incoming packets
-    kernel->interrupt->Schedule(this, NetworkTime, NetworkRecvInt);
+    // wait for incoming packets
+    kernel->interrupt->WatchFile(sock, this, NetworkTime, NetworkRecvInt);
 }
 
 //-----------------------------------------------------------------------
@@ -55,22 +56,40 @@ NetworkInput::~NetworkInput()
 //      First check to make sure packet is available & there's space to
 //	pull it in.  Then invoke the "callBack" registered by whoever 
 //	wants the packet.
+//
+//	We only watch the socket while there is space for a packet, so
+//	the network doesn't interrupt the CPU unless a packet arrives.
 //-----------------------------------------------------------------------
 
 void
 NetworkInput::CallBack()
 {
-    // schedule the next time to poll for a packet
-    kernel->interrupt->Schedule(this, NetworkTime, NetworkRecvInt);
+    ReplayLog *log = kernel->replayLog;
+    int readCount;
 
     if (inHdr.length != 0) 	// do nothing if packet is already buffered
 	return;		
-    if (!PollSocket(sock)) 	// do nothing if no packet to be read
-	return;
 
-    // otherwise, read packet in
+    // read the packet in, if there is one; when replaying, the
+    // packet comes from the log instead of the socket
     char *buffer = new char[MaxWireSize];
-    ReadFromSocket(sock, buffer, MaxWireSize);
+    if (log != NULL && log->IsReplaying()) {
+	readCount = log->ReplayData(ReplayInput, buffer, MaxWireSize);
+    } else {
+	readCount = -1;
+	if (PollSocket(sock)) {
+	    ReadFromSocket(sock, buffer, MaxWireSize);
+	    readCount = MaxWireSize;
+	}
+	if (log != NULL) {
+	    log->Record(ReplayInput, readCount, buffer, max(readCount, 0));
+	}
+    }
+    if (readCount < 0) { 	// nothing to be read after all
+	delete [] buffer;
+	kernel->interrupt->WatchFile(sock, this, NetworkTime, NetworkRecvInt);
+	return;
+    }
 
     // divide packet into header and data
     inHdr = *(PacketHeader *)buffer;
@@ -98,6 +117,8 @@ NetworkInput::Receive(char* data)
     inHdr.length = 0;
     if (hdr.length != 0) {
     	bcopy(inbox, data, hdr.length);
+	// wait for the next packet
+	kernel->interrupt->WatchFile(sock, this, NetworkTime, NetworkRecvInt);
     }
     return hdr;
 }
@@ -168,7 +189,9 @@ NetworkOutput::Send(PacketHeader hdr, const char *data)
 
     kernel->interrupt->Schedule(this, NetworkTime, NetworkSendInt);
 
-    if (RandomNumber() % 100 >= chanceToWork * 100) { // emulate a lost packet
+    ReplayLog *log = kernel->replayLog;
+    unsigned int number = (log != NULL) ? log->Random() : RandomNumber();
+    if (number % 100 >= chanceToWork * 100) { // emulate a lost packet
 	DEBUG(dbgNet, "oops, lost it!");
 	return;
     }
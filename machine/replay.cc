@@ -0,0 +1,251 @@
+// replay.cc
+//	Routines to record the external events of a run of Nachos, and
+//	to replay them.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "replay.h"
+#include "main.h"
+
+// for debugging and for reporting divergence
+static const char *replayKindNames[] = { "watch ready", "file ready",
+					"input", "random" };
+
+//----------------------------------------------------------------------
+// ReplayLog::ReplayLog
+//	Start recording to a new log, or read in a log to replay.
+//
+//	"fileName" -- the log
+//	"replay" -- if TRUE, replay the log; otherwise, record it
+//----------------------------------------------------------------------
+
+ReplayLog::ReplayLog(char *fileName, bool replay)
+{
+    unsigned int magic = ReplayMagic;
+
+    this->fileName = fileName;
+    replaying = replay;
+    numEvents = 0;
+    if (!replaying) {
+	fd = OpenForWrite(fileName);
+	contents = new char[ReplayBufferSize];
+	bcopy(&magic, contents, sizeof(magic));
+	size = sizeof(magic);
+	position = 0;
+	return;
+    }
+
+    fd = OpenForReadWrite(fileName, TRUE);
+    Lseek(fd, 0, SEEK_END);
+    size = Tell(fd);
+    Lseek(fd, 0, SEEK_SET);
+    contents = new char[size];
+    Read(fd, contents, size);
+    Close(fd);
+    fd = -1;
+    if (size >= (int) sizeof(magic)) {
+	bcopy(contents, &magic, sizeof(magic));
+    }
+    if (size < (int) sizeof(magic) || magic != ReplayMagic) {
+	std::cerr << fileName << " is not a replay log\n";
+	Abort();
+    }
+    position = sizeof(magic);
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::~ReplayLog
+//	When recording, write out the rest of the log.  When replaying,
+//	report whether the whole log was replayed.
+//----------------------------------------------------------------------
+
+ReplayLog::~ReplayLog()
+{
+    ReplayEvent event;
+
+    if (!replaying) {
+	Flush();
+	Close(fd);
+	std::cout << "Recorded " << numEvents << " events to " << fileName
+		  << "\n";
+    } else if (Next(&event)) {
+	std::cout << "Replayed " << numEvents << " events from " << fileName
+		  << "; stopped before the one at tick " << event.when << "\n";
+    } else {
+	std::cout << "Replayed all " << numEvents << " events from "
+		  << fileName << "\n";
+    }
+    delete [] contents;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Record
+//	Add an event to the log, at the current tick.  The log is
+//	buffered, and written out when the buffer fills up.
+//
+//	"kind" -- what kind of event it is
+//	"value" -- what happened
+//	"data", "length" -- the data that came with it, if any
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Record(ReplayKind kind, int value, char *data, int length)
+{
+    ReplayEvent event;
+
+    ASSERT(!replaying);
+    ASSERT(sizeof(event) + length <= ReplayBufferSize);
+    DEBUG(dbgInt, "Recording " << replayKindNames[kind] << " event, value "
+			<< value << ", at tick " << kernel->stats->totalTicks);
+    if (size + sizeof(event) + length > ReplayBufferSize) {
+	Flush();
+    }
+    event.when = kernel->stats->totalTicks;
+    event.kind = kind;
+    event.value = value;
+    event.length = length;
+    bcopy(&event, contents + size, sizeof(event));
+    size += sizeof(event);
+    if (length > 0) {
+	bcopy(data, contents + size, length);
+	size += length;
+    }
+    numEvents++;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Flush
+//	Write out the events buffered while recording.
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Flush()
+{
+    if (size > 0) {
+	WriteFile(fd, contents, size);
+	size = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Next
+//	Find the next event to replay, without consuming it.
+//
+// Returns:
+//	FALSE, if the whole log has been replayed
+//----------------------------------------------------------------------
+
+bool
+ReplayLog::Next(ReplayEvent *event)
+{
+    if (position + (int) sizeof(ReplayEvent) > size) {
+	return FALSE;
+    }
+    bcopy(contents + position, event, sizeof(ReplayEvent));
+    ASSERT(position + (int) sizeof(ReplayEvent) + event->length <= size);
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Replay
+//	Replay an event that only happens sometimes: if the next event
+//	in the log is of the kind asked for, and happened at the current
+//	tick, consume it.
+//
+// Returns:
+//	TRUE, and the event's value, if it was consumed
+//----------------------------------------------------------------------
+
+bool
+ReplayLog::Replay(ReplayKind kind, int *value)
+{
+    ReplayEvent event;
+
+    ASSERT(replaying);
+    if (!Next(&event)) {
+	return FALSE;
+    }
+    if (event.when < kernel->stats->totalTicks) {
+	Diverged(kind);			// we should have seen it by now
+    }
+    if (event.kind != kind || event.when != kernel->stats->totalTicks) {
+	return FALSE;
+    }
+    DEBUG(dbgInt, "Replaying " << replayKindNames[kind] << " event, value "
+			<< event.value);
+    *value = event.value;
+    position += sizeof(event) + event.length;
+    numEvents++;
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::ReplayData
+//	Replay an event that must be next in the log, because it was
+//	logged every time we got here while recording.
+//
+// Returns:
+//	the event's value, and its data in "data"
+//----------------------------------------------------------------------
+
+int
+ReplayLog::ReplayData(ReplayKind kind, char *data, int maxLength)
+{
+    ReplayEvent event;
+    int value;
+
+    if (!Next(&event) || event.length > maxLength || !Replay(kind, &value)) {
+	Diverged(kind);
+    }
+    if (event.length > 0) {
+	bcopy(contents + position - event.length, data, event.length);
+    }
+    return value;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Random
+//	Return a random number: a new one when recording, and the one
+//	that was recorded when replaying.
+//----------------------------------------------------------------------
+
+unsigned int
+ReplayLog::Random()
+{
+    unsigned int number;
+
+    if (replaying) {
+	return (unsigned int) ReplayData(ReplayRandom, NULL, 0);
+    }
+    number = RandomNumber();
+    Record(ReplayRandom, (int) number, NULL, 0);
+    return number;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Diverged
+//	The run has done something different from what was recorded,
+//	so it can't be replayed any further.  Say where, and stop.
+//
+//	"kind" -- the kind of event the run was looking for
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Diverged(ReplayKind kind)
+{
+    ReplayEvent event;
+
+    std::cerr << "Replay diverged from " << fileName << " at tick "
+	      << kernel->stats->totalTicks << ": expected a \""
+	      << replayKindNames[kind] << "\" event; ";
+    if (Next(&event)) {
+	std::cerr << "the log has a \"" << replayKindNames[event.kind]
+		  << "\" event at tick " << event.when << "\n";
+    } else {
+	std::cerr << "the log has ended\n";
+    }
+    Abort();
+}
@@ -0,0 +1,91 @@
+// replay.h
+//	Data structures for recording the external events of a run of
+//	Nachos, and replaying them, so the run can be repeated exactly.
+//
+//	A run is deterministic, tick for tick, except where the
+//	simulated hardware depends on the host: when console input or
+//	a packet arrives, what it holds, and the random numbers used to
+//	slice time and to drop packets.  With "-rec file", each of these
+//	events is logged, with the tick at which it happened.  With
+//	"-replay file", the devices take them from the log instead of
+//	from the host, so the run is repeated exactly -- useful for
+//	comparing the performance of two versions of the kernel on the
+//	same workload.
+//
+//	A run must be replayed with the same flags and user programs it
+//	was recorded with.  If it does something different anyway, it
+//	stops with a message saying where it diverged from the log.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "copyright.h"
+#include "utility.h"
+
+const unsigned int ReplayMagic = 0x4e525031;	// "NRP1", first in the file
+const int ReplayBufferSize = 65536;	// bytes of log written at a time
+
+// The kinds of events that are logged
+
+enum ReplayKind {
+    ReplayWatchReady,		// a file was always ready, when watched
+    ReplayFileReady,		// a watched file had input
+    ReplayInput,		// what a device read from the host
+    ReplayRandom		// a random number
+};
+
+// The following class defines the header of each event in the log;
+// the data the event carries, if any, follows it.
+
+class ReplayEvent {
+  public:
+    long long when;		// the tick when it happened
+    int kind;			// a ReplayKind
+    int value;			// what happened
+    int length;			// bytes of data that follow
+};
+
+// The following class records events to a log, or replays them from
+// one.
+
+class ReplayLog {
+  public:
+    ReplayLog(char *fileName, bool replay);
+				// Start a new log, or read one to replay
+    ~ReplayLog();		// Finish the log
+
+    bool IsReplaying() { return replaying; }
+
+    void Record(ReplayKind kind, int value, char *data, int length);
+				// Log an event, at the current tick
+    bool Replay(ReplayKind kind, int *value);
+				// If the next event in the log is of this
+				// kind, and happened now, consume it
+    int ReplayData(ReplayKind kind, char *data, int maxLength);
+				// Consume the next event, which must be of
+				// this kind and have happened now
+    unsigned int Random();	// A random number, from the host when
+				// recording, and from the log when replaying
+
+  private:
+    bool replaying;		// replaying a log, rather than recording?
+    char *fileName;
+    int fd;			// the log, while recording
+    char *contents;		// events not yet written out, or the whole
+				// log when replaying
+    int size;			// bytes in "contents"
+    int position;		// when replaying, where the next event is
+    int numEvents;		// events recorded or replayed so far
+
+    void Flush();		// Write out the buffered events
+    bool Next(ReplayEvent *event);
+				// The next event to replay; FALSE if none
+    void Diverged(ReplayKind kind);
+				// Stop, the run doesn't match the log
+};
+
+#endif // REPLAY_H
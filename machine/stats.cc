@@ -11,6 +11,61 @@
 #include "debug.h"
 #include "stats.h"
 
+const long long NoSnapshot = 0x7fffffffffffffffLL;	// never
+
+//----------------------------------------------------------------------
+// WriteString
+// 	Write a string to an open file.
+//----------------------------------------------------------------------
+
+static void
+WriteString(int fd, const char *text)
+{
+    WriteFile(fd, (char *) text, strlen(text));
+}
+
+//----------------------------------------------------------------------
+// StatHistogram::StatHistogram
+// 	Initialize an empty histogram.
+//----------------------------------------------------------------------
+
+StatHistogram::StatHistogram(const char *histogramName)
+{
+    name = histogramName;
+    count = sum = min = max = 0;
+    for (int i = 0; i < NumHistogramBuckets; i++) {
+	buckets[i] = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// StatHistogram::Record
+// 	Count one value, in the bucket for its highest bit.
+//----------------------------------------------------------------------
+
+void
+StatHistogram::Record(long long value)
+{
+    int bucket;
+
+    if (count == 0 || value < min) {
+	min = value;
+    }
+    if (count == 0 || value > max) {
+	max = value;
+    }
+    count++;
+    sum += value;
+    if (value <= 0) {
+	bucket = 0;
+    } else if (value > 0xffffffffLL) {
+	bucket = NumHistogramBuckets - 1;
+    } else {
+	bucket = highestBit((unsigned int) value) + 1;
+    }
+    buckets[bucket]++;
+}
+
 //----------------------------------------------------------------------
 // Statistics::Statistics
 // 	Initialize performance metrics to zero, at system startup.
@@ -22,6 +77,39 @@ Statistics::Statistics()
     numDiskReads = numDiskWrites = 0;
     numConsoleCharsRead = numConsoleCharsWritten = 0;
     numPageFaults = numPacketsSent = numPacketsRecvd = 0;
+    counters = new List<StatCounter *>;
+    histograms = new List<StatHistogram *>;
+    exportFile = -1;
+    exportCsv = FALSE;
+    snapshotInterval = 0;
+    nextSnapshot = NoSnapshot;
+    numSnapshots = 0;
+}
+
+//----------------------------------------------------------------------
+// Statistics::~Statistics
+// 	If we are exporting the statistics, write the last snapshot and
+//	close the file.  Then de-allocate the registered counters and
+//	histograms.
+//----------------------------------------------------------------------
+
+Statistics::~Statistics()
+{
+    if (exportFile >= 0) {
+	Snapshot();
+	if (!exportCsv) {
+	    WriteString(exportFile, "\n]}\n");
+	}
+	Close(exportFile);
+    }
+    while (!counters->IsEmpty()) {
+	delete counters->RemoveFront();
+    }
+    delete counters;
+    while (!histograms->IsEmpty()) {
+	delete histograms->RemoveFront();
+    }
+    delete histograms;
 }
 
 //----------------------------------------------------------------------
@@ -43,3 +131,198 @@ Statistics::Print()
     std::cout << "Network I/O: packets received " << numPacketsRecvd;
 		std::cout << ", sent " << numPacketsSent << "\n";
 }
+
+//----------------------------------------------------------------------
+// Statistics::RegisterCounter
+// 	Create a counter, to be exported with the other statistics.
+//	The Statistics own the counter, and delete it at shutdown.
+//
+//	"name" -- how the counter is labelled in the export
+//----------------------------------------------------------------------
+
+StatCounter *
+Statistics::RegisterCounter(const char *name)
+{
+    StatCounter *counter = new StatCounter(name);
+
+    counters->Append(counter);
+    return counter;
+}
+
+//----------------------------------------------------------------------
+// Statistics::RegisterHistogram
+// 	Create a histogram, to be exported with the other statistics.
+//	The Statistics own the histogram, and delete it at shutdown.
+//
+//	"name" -- how the histogram is labelled in the export
+//----------------------------------------------------------------------
+
+StatHistogram *
+Statistics::RegisterHistogram(const char *name)
+{
+    StatHistogram *histogram = new StatHistogram(name);
+
+    histograms->Append(histogram);
+    return histogram;
+}
+
+//----------------------------------------------------------------------
+// Statistics::Export
+// 	Start exporting the statistics to a file, as a series of 
+//	snapshots: one now, one every "interval" ticks, and one at 
+//	shutdown.  Snapshots are taken by the interrupt simulation, 
+//	when simulated time reaches NextSnapshot().
+//
+//	A JSON export is an object holding the interval, and an array
+//	of snapshots; each has the time, the counters by name, and the
+//	histograms by name.  A CSV export has one "ticks,name,value" row
+//	per statistic per snapshot.
+//
+//	"fileName" -- where to write the snapshots
+//	"interval" -- ticks between snapshots
+//----------------------------------------------------------------------
+
+void
+Statistics::Export(char *fileName, int interval)
+{
+    char buffer[100];
+    int length = strlen(fileName);
+
+    ASSERT(interval > 0);
+    exportFile = OpenForWrite(fileName);
+    exportCsv = (length > 4 && strcmp(fileName + length - 4, ".csv") == 0);
+    snapshotInterval = interval;
+    if (exportCsv) {
+	sprintf(buffer, "ticks,name,value\n");
+    } else {
+	sprintf(buffer, "{\"interval\": %d, \"snapshots\": [", interval);
+    }
+    WriteString(exportFile, buffer);
+    nextSnapshot = totalTicks;
+}
+
+//----------------------------------------------------------------------
+// Statistics::Snapshot
+// 	Write the current value of every statistic to the export file,
+//	and work out when the next snapshot is due.
+//----------------------------------------------------------------------
+
+void
+Statistics::Snapshot()
+{
+    char buffer[100];
+    bool first = TRUE;
+
+    if (exportFile < 0) {		// not exporting
+	return;
+    }
+    if (!exportCsv) {
+	sprintf(buffer, "%s\n{\"ticks\": %lld, \"counters\": {", 
+			(numSnapshots > 0) ? "," : "", totalTicks);
+	WriteString(exportFile, buffer);
+    }
+    WriteValue("totalTicks", totalTicks, TRUE);
+    WriteValue("idleTicks", idleTicks, FALSE);
+    WriteValue("systemTicks", systemTicks, FALSE);
+    WriteValue("userTicks", userTicks, FALSE);
+    WriteValue("numDiskReads", numDiskReads, FALSE);
+    WriteValue("numDiskWrites", numDiskWrites, FALSE);
+    WriteValue("numConsoleCharsRead", numConsoleCharsRead, FALSE);
+    WriteValue("numConsoleCharsWritten", numConsoleCharsWritten, FALSE);
+    WriteValue("numPageFaults", numPageFaults, FALSE);
+    WriteValue("numPacketsSent", numPacketsSent, FALSE);
+    WriteValue("numPacketsRecvd", numPacketsRecvd, FALSE);
+
+    ListIterator<StatCounter *> counterIter(counters);
+    for (; !counterIter.IsDone(); counterIter.Next()) {
+	WriteValue(counterIter.Item()->name, counterIter.Item()->value, FALSE);
+    }
+
+    if (!exportCsv) {
+	WriteString(exportFile, "}, \"histograms\": {");
+    }
+    ListIterator<StatHistogram *> histogramIter(histograms);
+    for (; !histogramIter.IsDone(); histogramIter.Next()) {
+	WriteHistogram(histogramIter.Item(), first);
+	first = FALSE;
+    }
+    if (!exportCsv) {
+	WriteString(exportFile, "}}");
+    }
+
+    numSnapshots++;
+    nextSnapshot = totalTicks - (totalTicks % snapshotInterval) 
+							+ snapshotInterval;
+}
+
+//----------------------------------------------------------------------
+// Statistics::WriteValue
+// 	Write one statistic, as part of a snapshot.
+//
+//	"name", "value" -- the statistic
+//	"first" -- is it the first in its JSON object?
+//----------------------------------------------------------------------
+
+void
+Statistics::WriteValue(const char *name, long long value, bool first)
+{
+    char buffer[200];
+
+    if (exportCsv) {
+	sprintf(buffer, "%lld,%s,%lld\n", totalTicks, name, value);
+    } else {
+	sprintf(buffer, "%s\"%s\": %lld", first ? "" : ", ", name, value);
+    }
+    WriteString(exportFile, buffer);
+}
+
+//----------------------------------------------------------------------
+// Statistics::WriteHistogram
+// 	Write a histogram, as part of a snapshot.  Only the buckets that
+//	aren't empty are written, each labelled by the (exclusive) upper 
+//	bound of its values.  In CSV, each part of the histogram is a 
+//	separate statistic: "name.count", "name.lt1024", etc.
+//
+//	"first" -- is it the first histogram in the JSON snapshot?
+//----------------------------------------------------------------------
+
+void
+Statistics::WriteHistogram(StatHistogram *histogram, bool first)
+{
+    char buffer[200];
+    bool firstBucket = TRUE;
+
+    if (exportCsv) {
+	sprintf(buffer, "%s.count", histogram->name);
+	WriteValue(buffer, histogram->count, FALSE);
+	sprintf(buffer, "%s.sum", histogram->name);
+	WriteValue(buffer, histogram->sum, FALSE);
+	sprintf(buffer, "%s.min", histogram->name);
+	WriteValue(buffer, histogram->min, FALSE);
+	sprintf(buffer, "%s.max", histogram->name);
+	WriteValue(buffer, histogram->max, FALSE);
+	for (int i = 0; i < NumHistogramBuckets; i++) {
+	    if (histogram->buckets[i] != 0) {
+		sprintf(buffer, "%s.lt%lld", histogram->name, 1LL << i);
+		WriteValue(buffer, histogram->buckets[i], FALSE);
+	    }
+	}
+	return;
+    }
+
+    sprintf(buffer, "%s\"%s\": {\"count\": %lld, \"sum\": %lld, "
+		"\"min\": %lld, \"max\": %lld, \"buckets\": [", 
+		first ? "" : ", ", histogram->name, histogram->count,
+		histogram->sum, histogram->min, histogram->max);
+    WriteString(exportFile, buffer);
+    for (int i = 0; i < NumHistogramBuckets; i++) {
+	if (histogram->buckets[i] != 0) {
+	    sprintf(buffer, "%s{\"lt\": %lld, \"count\": %lld}", 
+			firstBucket ? "" : ", ", 1LL << i, 
+			histogram->buckets[i]);
+	    WriteString(exportFile, buffer);
+	    firstBucket = FALSE;
+	}
+    }
+    WriteString(exportFile, "]}");
+}
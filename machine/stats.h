@@ -12,33 +12,105 @@
 #define STATS_H
 
 #include "copyright.h"
+#include "list.h"
+
+// The following class defines a counter that any part of Nachos can
+// register with the Statistics, by name, so that it is exported along
+// with the built-in statistics.
+
+class StatCounter {
+  public:
+    StatCounter(const char *counterName) { name = counterName; value = 0; }
+
+    void Add(long long n = 1) { value += n; }
+
+    const char *name;
+    long long value;
+};
+
+// The following class defines a histogram, for distributions such as 
+// latencies.  Bucket 0 counts the values that are zero or less; 
+// bucket i counts the values from 2^(i-1) up to 2^i - 1, with the
+// last bucket also counting everything larger.
+
+const int NumHistogramBuckets = 33;
+
+class StatHistogram {
+  public:
+    StatHistogram(const char *histogramName);
+
+    void Record(long long value);	// Count one value
+
+    const char *name;
+    long long count;		// number of values recorded
+    long long sum;		// their total
+    long long min, max;		// smallest and largest
+    long long buckets[NumHistogramBuckets];
+};
 
 // The following class defines the statistics that are to be kept
 // about Nachos behavior -- how much time (ticks) elapsed, how
-// many user instructions executed, etc.
+// many user instructions executed, etc.  They are 64 bits, so that
+// long simulations don't overflow them.
 //
 // The fields in this class are public to make it easier to update.
+//
+// Other parts of Nachos can register their own counters and 
+// histograms.  All the statistics can be exported, in JSON or CSV,
+// as a series of snapshots taken every so many ticks, to follow
+// them over the life of a simulation.
 
 class Statistics {
   public:
-    int totalTicks;      	// Total time running Nachos
-    int idleTicks;       	// Time spent idle (no threads to run)
-    int systemTicks;	 	// Time spent executing system code
-    int userTicks;       	// Time spent executing user code
+    long long totalTicks;      	// Total time running Nachos
+    long long idleTicks;       	// Time spent idle (no threads to run)
+    long long systemTicks;	// Time spent executing system code
+    long long userTicks;       	// Time spent executing user code
 				// (this is also equal to # of
 				// user instructions executed)
 
-    int numDiskReads;		// number of disk read requests
-    int numDiskWrites;		// number of disk write requests
-    int numConsoleCharsRead;	// number of characters read from the keyboard
-    int numConsoleCharsWritten; // number of characters written to the display
-    int numPageFaults;		// number of virtual memory page faults
-    int numPacketsSent;		// number of packets sent over the network
-    int numPacketsRecvd;	// number of packets received over the network
+    long long numDiskReads;	// number of disk read requests
+    long long numDiskWrites;	// number of disk write requests
+    long long numConsoleCharsRead;
+				// number of characters read from the keyboard
+    long long numConsoleCharsWritten; 
+				// number of characters written to the display
+    long long numPageFaults;	// number of virtual memory page faults
+    long long numPacketsSent;	// number of packets sent over the network
+    long long numPacketsRecvd;	// number of packets received over the network
 
     Statistics(); 		// initialize everything to zero
+    ~Statistics();		// finish exporting, if we are
 
     void Print();		// print collected statistics
+
+    StatCounter *RegisterCounter(const char *name);
+    StatHistogram *RegisterHistogram(const char *name);
+				// Create a named counter or histogram,
+				// to be exported with the others
+
+    void Export(char *fileName, int interval);
+				// Write a snapshot of the statistics to 
+				// "fileName" every "interval" ticks, and
+				// at the end; CSV if the name ends in
+				// ".csv", otherwise JSON
+    long long NextSnapshot() { return nextSnapshot; }
+				// When the next snapshot is due
+    void Snapshot();		// Write the statistics to the export
+				// file
+
+  private:
+    List<StatCounter *> *counters;	// registered counters
+    List<StatHistogram *> *histograms;	// registered histograms
+    int exportFile;		// file snapshots are written to, or -1
+    bool exportCsv;		// CSV rather than JSON?
+    int snapshotInterval;	// ticks between snapshots
+    long long nextSnapshot;	// when the next snapshot is due
+    int numSnapshots;		// snapshots written so far
+
+    void WriteValue(const char *name, long long value, bool first);
+				// write one statistic of a snapshot
+    void WriteHistogram(StatHistogram *histogram, bool first);
 };
 
 // Constants used to reflect the relative time an operation would
@@ -57,4 +129,7 @@ const int ConsoleTime =	 100;	// time to read or write one character
 const int NetworkTime =	 100;  	// time to send or receive one packet
 const int TimerTicks = 	 100;  	// (average) time between timer interrupts
 
+const int DefaultSnapshotInterval = 10000;
+				// default time between exported snapshots
+
 #endif // STATS_H
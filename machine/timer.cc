@@ -23,6 +23,7 @@
 #include "timer.h"
 #include "main.h"
 #include "sysdep.h"
+#include "replay.h"
 
 //----------------------------------------------------------------------
 // Timer::Timer
@@ -40,9 +41,41 @@ Timer::Timer(bool doRandom, CallBackObj *toCall)
     randomize = doRandom;
     callPeriodically = toCall;
     disable = FALSE;
+    stopped = FALSE;
     SetInterrupt();
 }
 
+//----------------------------------------------------------------------
+// Timer::Stop
+//      Stop the timer, cancelling the next interrupt, until it is 
+//	started again.  May be called from the interrupt handler, in
+//	which case no next interrupt is scheduled.
+//----------------------------------------------------------------------
+
+void
+Timer::Stop()
+{
+    if (!stopped) {
+	stopped = TRUE;
+	(void) kernel->interrupt->Cancel(this, TimerInt);
+    }
+}
+
+//----------------------------------------------------------------------
+// Timer::Start
+//      Restart a stopped timer; the next interrupt comes a full 
+//	interval from now.
+//----------------------------------------------------------------------
+
+void
+Timer::Start()
+{
+    if (stopped) {
+	stopped = FALSE;
+	SetInterrupt();
+    }
+}
+
 //----------------------------------------------------------------------
 // Timer::CallBack
 //      Routine called when interrupt is generated by the hardware 
@@ -69,11 +102,14 @@ Timer::CallBack()
 void
 Timer::SetInterrupt() 
 {
-    if (!disable) {
+    if (!disable && !stopped) {
        int delay = TimerTicks;
     
-       if (randomize) {
-	     delay = 1 + (RandomNumber() % (TimerTicks * 2));
+       if (randomize) {	// the random number is logged, for replay
+	     ReplayLog *log = kernel->replayLog;
+	     unsigned int number = (log != NULL) ? log->Random() : RandomNumber();
+
+	     delay = 1 + (number % (TimerTicks * 2));
         }
        // schedule the next timer device interrupt
        kernel->interrupt->Schedule(this, delay, TimerInt);
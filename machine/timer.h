@@ -36,11 +36,16 @@ class Timer : public CallBackObj {
     				// Turn timer device off, so it doesn't
 				// generate any more interrupts.
 
+    void Stop();		// Stop generating interrupts for now
+    void Start();		// Start again, if stopped
+    bool IsStopped() { return stopped; }
+
   private:
     bool randomize;		// set if we need to use a random timeout delay
     CallBackObj *callPeriodically; // call this every TimerTicks time units 
     bool disable;		// turn off the timer device after next
     				// interrupt.
+    bool stopped;		// no interrupt scheduled, until Start
     
     void CallBack();		// called internally when the hardware
 				// timer generates an interrupt
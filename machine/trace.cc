@@ -0,0 +1,535 @@
+// trace.cc
+//	Routines to record a binary trace of user instructions, and to
+//	analyze one afterwards; and to count user instructions as they
+//	execute.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "trace.h"
+#include "machine.h"
+#include "main.h"
+
+const int NumDistanceBuckets = 33;	// power of 2 buckets of reuse distance
+const int WorkingSetInterval = 10000;	// instructions per working set sample
+const int InitialAddressTable = 1024;	// starting size of an AddressTable
+const int NumCountsReported = 20;	// branches and blocks listed by "-ic"
+
+//----------------------------------------------------------------------
+// TraceWriter::TraceWriter
+//	Create the trace file, and write the header that identifies it.
+//
+//	"fileName" -- where to write the trace
+//----------------------------------------------------------------------
+
+TraceWriter::TraceWriter(char *fileName)
+{
+    unsigned int magic = TraceMagic;
+
+    fd = OpenForWrite(fileName);
+    WriteFile(fd, (char *) &magic, sizeof(magic));
+    buffer = new TraceRecord[TraceBufferSize];
+    bzero((char *) buffer, TraceBufferSize * sizeof(TraceRecord));
+    numBuffered = 0;
+    numRecorded = 0;
+}
+
+//----------------------------------------------------------------------
+// TraceWriter::~TraceWriter
+//	Write out the records still in the buffer, and close the file.
+//----------------------------------------------------------------------
+
+TraceWriter::~TraceWriter()
+{
+    Flush();
+    Close(fd);
+    delete [] buffer;
+    std::cout << "Instruction trace: " << numRecorded << " records\n";
+}
+
+//----------------------------------------------------------------------
+// TraceWriter::Flush
+//	Write out the buffered records, with a single write.
+//----------------------------------------------------------------------
+
+void
+TraceWriter::Flush()
+{
+    if (numBuffered > 0) {
+	WriteFile(fd, (char *) buffer, numBuffered * sizeof(TraceRecord));
+	numRecorded += numBuffered;
+	numBuffered = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// AddressTable::AddressTable
+//	Initialize an empty table.
+//----------------------------------------------------------------------
+
+AddressTable::AddressTable()
+{
+    size = InitialAddressTable;
+    numUsed = 0;
+    keys = new unsigned int[size];
+    values = new long long[size];
+    used = new bool[size];
+    for (int i = 0; i < size; i++) {
+	used[i] = FALSE;
+    }
+}
+
+//----------------------------------------------------------------------
+// AddressTable::Slot
+//	Return the entry that holds an address, or the unused entry
+//	where it would go.
+//----------------------------------------------------------------------
+
+int
+AddressTable::Slot(unsigned int address)
+{
+    int i = (address * 2654435761U) & (size - 1);
+
+    while (used[i] && keys[i] != address) {
+	i = (i + 1) & (size - 1);
+    }
+    return i;
+}
+
+//----------------------------------------------------------------------
+// AddressTable::Grow
+//	Double the size of the table, and re-insert every entry.
+//----------------------------------------------------------------------
+
+void
+AddressTable::Grow()
+{
+    unsigned int *oldKeys = keys;
+    long long *oldValues = values;
+    bool *oldUsed = used;
+    int oldSize = size;
+
+    size *= 2;
+    keys = new unsigned int[size];
+    values = new long long[size];
+    used = new bool[size];
+    for (int i = 0; i < size; i++) {
+	used[i] = FALSE;
+    }
+    for (int i = 0; i < oldSize; i++) {
+	if (oldUsed[i]) {
+	    int j = Slot(oldKeys[i]);
+	    used[j] = TRUE;
+	    keys[j] = oldKeys[i];
+	    values[j] = oldValues[i];
+	}
+    }
+    delete [] oldKeys;
+    delete [] oldValues;
+    delete [] oldUsed;
+}
+
+//----------------------------------------------------------------------
+// AddressTable::Find
+//	Return the value kept for an address, adding the address with
+//	a value of 0 if it isn't there yet (doubling the table first if
+//	it is half full).
+//----------------------------------------------------------------------
+
+long long *
+AddressTable::Find(unsigned int address)
+{
+    int i = Slot(address);
+
+    if (!used[i]) {
+	if (2 * (numUsed + 1) > size) {
+	    Grow();
+	    i = Slot(address);
+	}
+	used[i] = TRUE;
+	keys[i] = address;
+	values[i] = 0;
+	numUsed++;
+    }
+    return &values[i];
+}
+
+//----------------------------------------------------------------------
+// AddressTable::Export
+//	Copy out the addresses in the table, and their values.
+//
+//	"keys", "values" -- where to put them; must have room for
+//		NumEntries() of each
+//----------------------------------------------------------------------
+
+void
+AddressTable::Export(unsigned int *keys, long long *values)
+{
+    int n = 0;
+
+    for (int i = 0; i < size; i++) {
+	if (used[i]) {
+	    keys[n] = this->keys[i];
+	    values[n] = this->values[i];
+	    n++;
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// AddressTable::Total
+//	Return the sum of the values in the table.
+//----------------------------------------------------------------------
+
+long long
+AddressTable::Total()
+{
+    long long total = 0;
+
+    for (int i = 0; i < size; i++) {
+	if (used[i]) {
+	    total += values[i];
+	}
+    }
+    return total;
+}
+
+//----------------------------------------------------------------------
+// MarkAccess, CountMarks
+//	The reuse distance of an access is the number of distinct words
+//	accessed since the last access to the same word.  To find it, a
+//	Fenwick tree over the accesses, in order, marks the ones that
+//	were the most recent access to their word; counting the marks
+//	after the word's previous access gives the distance.
+//----------------------------------------------------------------------
+
+static void
+MarkAccess(int *tree, int size, int index, int delta)
+{
+    for (; index <= size; index += index & -index) {
+	tree[index] += delta;
+    }
+}
+
+static int
+CountMarks(int *tree, int index)	// marks at or before "index"
+{
+    int count = 0;
+
+    for (; index > 0; index -= index & -index) {
+	count += tree[index];
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------
+// PrintCount
+//	Print one line of the trace report.
+//----------------------------------------------------------------------
+
+static void
+PrintCount(const char *label, long long count, long long total)
+{
+    char line[200];
+
+    sprintf(line, "  %-12s %12lld %6.2f%%\n", label, count,
+			(total == 0) ? 0.0 : (100.0 * count) / total);
+    std::cout << line;
+}
+
+//----------------------------------------------------------------------
+// PrintMix
+//	Print the instruction mix, most frequent opcodes first.
+//
+//	"opCounts" -- instructions executed, by opcode
+//	"total" -- instructions executed in all
+//----------------------------------------------------------------------
+
+static void
+PrintMix(long long *opCounts, long long total)
+{
+    long long counts[NumOpCodes];
+    char name[20];
+
+    for (int i = 0; i < NumOpCodes; i++) {
+	counts[i] = opCounts[i];
+    }
+    std::cout << "Instruction mix:\n";
+    for (;;) {
+	int best = 0;
+
+	for (int i = 1; i < NumOpCodes; i++) {
+	    if (counts[i] > counts[best]) {
+		best = i;
+	    }
+	}
+	if (counts[best] == 0) {
+	    break;
+	}
+	OpCodeName(best, name);
+	PrintCount(name, counts[best], total);
+	counts[best] = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// AnalyzeTrace
+//	Read a trace written with "-tr", and report:
+//	  the instruction mix, most frequent opcodes first;
+//	  the reuse distances of loads and stores, by word, in power
+//	    of 2 buckets;
+//	  the working set -- the distinct pages fetched from, loaded
+//	    from or stored to -- in each interval of WorkingSetInterval
+//	    instructions.
+//
+//	"fileName" -- the trace
+//----------------------------------------------------------------------
+
+void
+AnalyzeTrace(char *fileName)
+{
+    long long opCounts[NumOpCodes], distances[NumDistanceBuckets];
+    long long numInstructions = 0, numLoads = 0, numStores = 0, numCold = 0;
+    long long workingSetTotal = 0;
+    int workingSet = 0, maxWorkingSet = 0, numIntervals = 0;
+    AddressTable lastAccess, lastInterval;
+    TraceRecord *buffer = new TraceRecord[TraceBufferSize];
+    int *tree, numRecords, numAccesses = 0;
+    unsigned int magic;
+    char name[40];
+    long long *slot;
+    int fd, size;
+
+    fd = OpenForReadWrite(fileName, FALSE);
+    if (fd < 0) {
+	std::cout << "Can't open trace " << fileName << "\n";
+	delete [] buffer;
+	return;
+    }
+    Lseek(fd, 0, SEEK_END);
+    size = Tell(fd);
+    Lseek(fd, 0, SEEK_SET);
+    magic = 0;
+    if (size >= (int) sizeof(magic)) {
+	Read(fd, (char *) &magic, sizeof(magic));
+    }
+    if (magic != TraceMagic) {
+	std::cout << fileName << " is not an instruction trace\n";
+	Close(fd);
+	delete [] buffer;
+	return;
+    }
+    numRecords = (size - sizeof(magic)) / sizeof(TraceRecord);
+    tree = new int[numRecords + 1];		// at most one access per record
+    bzero((char *) tree, (numRecords + 1) * sizeof(int));
+    for (int i = 0; i < NumOpCodes; i++) {
+	opCounts[i] = 0;
+    }
+    for (int i = 0; i < NumDistanceBuckets; i++) {
+	distances[i] = 0;
+    }
+
+    for (int done = 0; done < numRecords; ) {
+	int count = min(numRecords - done, TraceBufferSize);
+
+	Read(fd, (char *) buffer, count * sizeof(TraceRecord));
+	for (int i = 0; i < count; i++) {
+	    TraceRecord *record = &buffer[i];
+
+	    numInstructions++;
+	    opCounts[record->opCode & (NumOpCodes - 1)]++;
+
+	    slot = lastInterval.Find(record->pc / PageSize);
+	    if (*slot != numIntervals + 1) {	// first touch this interval
+		*slot = numIntervals + 1;
+		workingSet++;
+	    }
+	    if (record->access != TraceNone) {
+		if (record->access == TraceLoad) {
+		    numLoads++;
+		} else {
+		    numStores++;
+		}
+		slot = lastInterval.Find(record->address / PageSize);
+		if (*slot != numIntervals + 1) {
+		    *slot = numIntervals + 1;
+		    workingSet++;
+		}
+
+		numAccesses++;
+		slot = lastAccess.Find(record->address / sizeof(int));
+		if (*slot == 0) {
+		    numCold++;			// first access to the word
+		} else {
+		    int distance = CountMarks(tree, numAccesses - 1)
+						- CountMarks(tree, (int) *slot);
+		    int bucket = 0;
+
+		    while (distance > 0) {
+			distance >>= 1;
+			bucket++;
+		    }
+		    distances[bucket]++;
+		    MarkAccess(tree, numRecords, (int) *slot, -1);
+		}
+		MarkAccess(tree, numRecords, numAccesses, 1);
+		*slot = numAccesses;
+	    }
+
+	    if (numInstructions % WorkingSetInterval == 0) {
+		workingSetTotal += workingSet;
+		maxWorkingSet = max(maxWorkingSet, workingSet);
+		numIntervals++;
+		workingSet = 0;
+	    }
+	}
+	done += count;
+    }
+    if (workingSet > 0) {			// the last, partial interval
+	workingSetTotal += workingSet;
+	maxWorkingSet = max(maxWorkingSet, workingSet);
+	numIntervals++;
+    }
+    Close(fd);
+    delete [] tree;
+    delete [] buffer;
+
+    std::cout << "Trace " << fileName << ": " << numInstructions
+	      << " instructions, " << numLoads << " loads, " << numStores
+	      << " stores\n";
+
+    PrintMix(opCounts, numInstructions);
+
+    std::cout << "Reuse distance of loads and stores (distinct words):\n";
+    PrintCount("first use", numCold, numAccesses);
+    PrintCount("0", distances[0], numAccesses);
+    for (int i = 1; i < NumDistanceBuckets; i++) {
+	if (distances[i] > 0) {
+	    sprintf(name, "%u-%u", 1U << (i - 1), (1U << i) - 1);
+	    PrintCount(name, distances[i], numAccesses);
+	}
+    }
+
+    std::cout << "Working set, per " << WorkingSetInterval
+	      << " instructions: ";
+    if (numIntervals == 0) {
+	std::cout << "empty trace\n";
+    } else {
+	std::cout << (double) workingSetTotal / numIntervals
+		  << " pages average, " << maxWorkingSet << " max, over "
+		  << numIntervals << " intervals\n";
+    }
+}
+
+//----------------------------------------------------------------------
+// InstructionCounter::InstructionCounter
+//	Initialize the counters.  Execution starts a basic block at
+//	address 0, where user programs start.
+//----------------------------------------------------------------------
+
+InstructionCounter::InstructionCounter()
+{
+    for (int i = 0; i < NumOpCodes; i++) {
+	opCounts[i] = 0;
+    }
+    nextBlock = 0;
+}
+
+//----------------------------------------------------------------------
+// InstructionCounter::Transfer
+//	Count a branch or a jump, which ends a basic block; the next
+//	one starts where the branch leads.
+//
+//	"pc" -- where the branch or jump is
+//	"conditional" -- is it a conditional branch?
+//	"taken" -- if so, was it taken?
+//	"target" -- where execution continues, after the delay slot
+//----------------------------------------------------------------------
+
+void
+InstructionCounter::Transfer(unsigned int pc, bool conditional, bool taken,
+						unsigned int target)
+{
+    if (conditional) {
+	(*branches.Find(pc))++;
+	if (taken) {
+	    (*this->taken.Find(pc))++;
+	}
+    }
+    nextBlock = target;
+}
+
+//----------------------------------------------------------------------
+// PrintLargest
+//	Print the addresses with the largest counts in a table, largest
+//	first, each with the share of "total" it has.  If "taken" is
+//	not NULL, also print the share of each count that was taken.
+//----------------------------------------------------------------------
+
+static void
+PrintLargest(AddressTable *table, long long total, AddressTable *taken)
+{
+    int n = table->NumEntries();
+    unsigned int *keys = new unsigned int[n];
+    long long *values = new long long[n];
+    char line[200];
+
+    table->Export(keys, values);
+    for (int k = 0; k < NumCountsReported && k < n; k++) {
+	int best = k;
+
+	for (int i = k + 1; i < n; i++) {
+	    if (values[i] > values[best]) {
+		best = i;
+	    }
+	}
+	unsigned int key = keys[best];
+	long long value = values[best];
+
+	keys[best] = keys[k];			// selection sort, as far as
+	values[best] = values[k];		// we print
+	keys[k] = key;
+	values[k] = value;
+	sprintf(line, "  0x%-10x %12lld %6.2f%%", key, value,
+			(total == 0) ? 0.0 : (100.0 * value) / total);
+	std::cout << line;
+	if (taken != NULL) {
+	    sprintf(line, "  %6.2f%% taken", (100.0 * *taken->Find(key)) / value);
+	    std::cout << line;
+	}
+	std::cout << "\n";
+    }
+    delete [] keys;
+    delete [] values;
+}
+
+//----------------------------------------------------------------------
+// InstructionCounter::Print
+//	Print the instruction mix, then the conditional branches and
+//	basic blocks executed most often.
+//----------------------------------------------------------------------
+
+void
+InstructionCounter::Print()
+{
+    long long numInstructions = 0, numBranches, numBlocks;
+
+    for (int i = 0; i < NumOpCodes; i++) {
+	numInstructions += opCounts[i];
+    }
+    std::cout << "Instruction counts: " << numInstructions
+	      << " instructions\n";
+    PrintMix(opCounts, numInstructions);
+
+    numBranches = branches.Total();
+    std::cout << "Conditional branches: " << numBranches << " executed, at "
+	      << branches.NumEntries() << " places; most executed:\n";
+    PrintLargest(&branches, numBranches, &taken);
+
+    numBlocks = blocks.Total();
+    std::cout << "Basic blocks: " << numBlocks << " entered, "
+	      << blocks.NumEntries() << " different; most entered:\n";
+    PrintLargest(&blocks, numBlocks, NULL);
+}
@@ -0,0 +1,145 @@
+// trace.h
+//	Data structures for recording a binary trace of the instructions
+//	user programs execute, and for analyzing the trace afterwards;
+//	and for counting the instructions as they execute.
+//
+//	Tracing with "-d m" formats every instruction as text, which
+//	slows the simulation down by orders of magnitude.  Instead,
+//	"-tr file" writes one fixed-size record per instruction -- its
+//	PC, its opcode, and the address it loads or stores, if any --
+//	into a large buffer that is only written out when it fills up.
+//
+//	"-ta file" reads a trace back, without running anything, and
+//	reports the instruction mix, the reuse distances of memory
+//	accesses, and the working set of pages, so a workload can be
+//	studied many ways after being run once.
+//
+//	Records are in the host's byte order, and addresses are virtual;
+//	the trace doesn't say which address space an instruction ran in.
+//	Instructions are recorded as they are issued, so one that traps
+//	(for instance, on a page fault) and is restarted appears twice.
+//
+//	"-ic" counts instructions by opcode, conditional branches by
+//	whether they were taken, and basic blocks by how often they
+//	were entered, and prints the counts when Nachos halts.  A basic
+//	block is counted when execution reaches the instruction a branch
+//	or jump leads to (after its delay slot).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "copyright.h"
+#include "utility.h"
+
+const unsigned int TraceMagic = 0x4e545231;	// "NTR1", first in the file
+const int TraceBufferSize = 65536;	// records written at a time
+const int NumOpCodes = 64;		// opcodes are 0..MaxOpcode in mipssim.h
+
+// Kinds of memory access an instruction makes
+
+enum TraceAccess { TraceNone, TraceLoad, TraceStore };
+
+// The following class defines one record of the trace file.
+
+class TraceRecord {
+  public:
+    unsigned int pc;		// where the instruction is
+    unsigned int address;	// address loaded or stored; 0 if none
+    unsigned char opCode;	// what it is; see mipssim.h
+    unsigned char access;	// a TraceAccess
+    unsigned char unused[2];	// keeps the record size fixed
+};
+
+// The following class writes the trace, a buffer at a time.
+
+class TraceWriter {
+  public:
+    TraceWriter(char *fileName);	// start a new trace file
+    ~TraceWriter();			// write what is left, and close it
+
+    void Record(unsigned int pc, int opCode, TraceAccess access,
+						unsigned int address) {
+	TraceRecord *record = &buffer[numBuffered];
+
+	record->pc = pc;
+	record->address = address;
+	record->opCode = opCode;
+	record->access = access;
+	if (++numBuffered == TraceBufferSize) {
+	    Flush();
+	}
+    }				// Add one instruction to the trace
+
+  private:
+    int fd;			// the trace file
+    TraceRecord *buffer;	// records not yet written out
+    int numBuffered;		// how many
+    long long numRecorded;	// records written out so far
+
+    void Flush();		// Write out the buffer
+};
+
+// The following class maps addresses to counts (0 until set).  It is
+// an open-addressing hash table, doubled in size as it fills up.
+
+class AddressTable {
+  public:
+    AddressTable();		// no addresses in it yet
+    ~AddressTable() { delete [] keys; delete [] values; delete [] used; }
+
+    long long *Find(unsigned int address);
+				// The value kept for "address", adding
+				// it if it isn't there yet
+    int NumEntries() { return numUsed; }
+    void Export(unsigned int *keys, long long *values);
+				// Copy out the addresses and values
+    long long Total();		// Sum of the values
+
+  private:
+    unsigned int *keys;
+    long long *values;
+    bool *used;			// which entries are in use
+    int size;			// entries in the table; a power of 2
+    int numUsed;		// entries in use
+
+    int Slot(unsigned int address);
+				// Where "address" is, or should go
+    void Grow();		// Double the table
+};
+
+// The following class counts instructions as they execute.
+
+class InstructionCounter {
+  public:
+    InstructionCounter();	// nothing counted yet
+
+    void Count(unsigned int pc, int opCode) {
+	opCounts[opCode]++;
+	if (pc == nextBlock) {
+	    (*blocks.Find(pc))++;
+	}
+    }				// Called for each instruction executed
+    void Transfer(unsigned int pc, bool conditional, bool taken,
+						unsigned int target);
+				// Called for each branch or jump; execution
+				// continues at "target" after the delay slot
+    void Print();		// Print the counts, largest first
+
+  private:
+    long long opCounts[NumOpCodes];	// instructions, by opcode
+    AddressTable branches;	// conditional branches executed, by PC
+    AddressTable taken;		// how many of them were taken
+    AddressTable blocks;	// times each basic block was entered
+    unsigned int nextBlock;	// where the next basic block starts
+};
+
+extern void AnalyzeTrace(char *fileName);
+				// Report on a trace file
+extern void OpCodeName(int opCode, char *name);
+				// Mnemonic of an opcode (in mipssim.cc)
+
+#endif // TRACE_H
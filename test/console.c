@@ -0,0 +1,55 @@
+/* console.c
+ *	Simple program to test reading the console in bulk.
+ *
+ *	Read console input until EOF, and check that all of it arrives.
+ *	Run it with the input taken from console.in:
+ *
+ *		nachos -ci console.in -x console.noff
+ *
+ *	console.in holds LINES lines of the alphabet, each LINE_LENGTH
+ *	characters long with its newline -- several times the size of
+ *	the blocks the console device delivers -- so a Read that returns
+ *	EOF before the end of the file is reported.
+ */
+
+#include "syscall.h"
+
+#define LINES		8
+#define LINE_LENGTH	64
+#define EXPECTED	(LINES * LINE_LENGTH)
+#define CHUNK		100	/* not a multiple of the device block */
+
+/* the character expected at offset "i" of console.in */
+char
+Expected(int i)
+{
+    if (i % LINE_LENGTH == LINE_LENGTH - 1) {
+	return '\n';
+    }
+    return 'a' + (i % LINE_LENGTH) % 26;
+}
+
+int
+main()
+{
+    char buffer[CHUNK];
+    int total = 0;
+    int n, i;
+
+    while ((n = Read(buffer, CHUNK, ConsoleIn)) > 0) {
+	for (i = 0; i < n; i++) {
+	    if (total + i >= EXPECTED || buffer[i] != Expected(total + i)) {
+		Write("console: wrong input\n", 21, ConsoleOut);
+		Halt();
+	    }
+	}
+	total += n;
+    }
+    if (total < EXPECTED) {
+	Write("console: early EOF\n", 19, ConsoleOut);
+    } else {
+	Write("console: OK\n", 12, ConsoleOut);
+    }
+    Halt();
+    /* not reached */
+}
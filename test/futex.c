@@ -0,0 +1,25 @@
+/* futex.c
+ *	Simple program to test the FutexWait and FutexWake system calls.
+ *
+ *	With only one thread, nobody can wake us up, so just check that
+ *	waiting on a word that has already changed returns at once, and
+ *	that waking an address nobody waits on wakes nobody.
+ */
+
+#include "syscall.h"
+
+int word = 1;
+
+int
+main()
+{
+    if (FutexWait(&word, 0) != EWOULDBLOCK) {
+	Write("wait should not block\n", 22, ConsoleOut);
+    } else if (FutexWake(&word, 1) != 0) {
+	Write("wake should wake nobody\n", 24, ConsoleOut);
+    } else {
+	Write("futex ok\n", 9, ConsoleOut);
+    }
+    Halt();
+    /* not reached */
+}
@@ -0,0 +1,36 @@
+/* pipe.c
+ *	Simple program to test the Pipe system call.
+ *
+ *	Write a message into a pipe, read it back out, and echo it
+ *	to the console.  Then close the write end, and check that
+ *	the read end sees EOF.
+ *
+ *	NOTE: the pipe holds PipeSize bytes, so with both ends in one
+ *	program the message has to fit, or the Write would wait forever.
+ */
+
+#include "syscall.h"
+
+int
+main()
+{
+    OpenFileId fds[2];
+    char buffer[32];
+    int n;
+
+    if (Pipe(fds) < 0) {
+	Halt();
+    }
+    Write("Hello through a pipe!\n", 22, fds[1]);
+    n = Read(buffer, 32, fds[0]);
+    Write(buffer, n, ConsoleOut);
+
+    Close(fds[1]);
+    if (Read(buffer, 32, fds[0]) == 0) {
+	Write("EOF\n", 4, ConsoleOut);
+    }
+    Close(fds[0]);
+
+    Halt();
+    /* not reached */
+}
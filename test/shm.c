@@ -0,0 +1,43 @@
+/* shm.c
+ *	Simple program to test the shared memory and semaphore system calls.
+ *
+ *	Create a shared segment and a semaphore, attach the segment, and
+ *	fill it in while holding the semaphore.  Another program that 
+ *	creates the same keys gets the same segment and semaphore.
+ */
+
+#include "syscall.h"
+
+#define SHM_KEY		1234
+#define SEM_KEY		1234
+#define SHM_SIZE	256
+
+int
+main()
+{
+    char *shared = (char *) 0x100000;
+    int shm, sem, i;
+
+    shm = ShmCreate(SHM_KEY, SHM_SIZE);
+    sem = SemCreate(SEM_KEY, 1);
+    if (shm < 0 || sem < 0 || ShmAttach(shm, shared) < 0) {
+	Halt();
+    }
+
+    SemP(sem);
+    for (i = 0; i < SHM_SIZE; i++) {
+	shared[i] = (char) i;
+    }
+    for (i = 0; i < SHM_SIZE; i++) {
+	if (shared[i] != (char) i) {
+	    Write("shared memory mismatch\n", 23, ConsoleOut);
+	    Halt();
+	}
+    }
+    SemV(sem);
+    Write("shared memory ok\n", 17, ConsoleOut);
+
+    ShmDetach(shm);
+    Halt();
+    /* not reached */
+}
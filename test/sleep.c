@@ -0,0 +1,25 @@
+/* sleep.c
+ *	Simple program to test the Sleep system call.
+ *
+ *	Sleep a few times, printing after each.  Run with "-d t" to
+ *	see when the thread is put to sleep and woken up.
+ */
+
+#include "syscall.h"
+
+int
+main()
+{
+    int i;
+
+    for (i = 0; i < 3; i++) {
+	if (Sleep(1000) != 0) {
+	    Write("sleep failed\n", 13, ConsoleOut);
+	    Halt();
+	}
+	Write("tick\n", 5, ConsoleOut);
+    }
+    Write("sleep ok\n", 9, ConsoleOut);
+    Halt();
+    /* not reached */
+}
@@ -1,8 +1,6 @@
 // alarm.cc
 //	Routines to use a hardware timer device to provide a
-//	software alarm clock.  For now, we just provide time-slicing.
-//
-//	Not completely implemented.
+//	software alarm clock: time-slicing, and timed sleeps.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -18,11 +16,16 @@
 //
 //      "doRandom" -- if true, arrange for the hardware interrupts to 
 //		occur at random, instead of fixed, intervals.
+//	"tickless" -- if true, stop the timer whenever no thread is
+//		waiting for the CPU, so that idle time and a lone
+//		running thread don't generate timer interrupts.
 //----------------------------------------------------------------------
 
-Alarm::Alarm(bool doRandom)
+Alarm::Alarm(bool doRandom, bool tickless)
 {
+    this->tickless = tickless;
     timer = new Timer(doRandom, this);
+    sleepQueue = new SleepQueue();
 }
 
 //----------------------------------------------------------------------
@@ -40,7 +43,12 @@ Alarm::Alarm(bool doRandom)
 //	was interrupted.
 //
 //	For now, just provide time-slicing.  Only need to time slice 
-//      if we're currently running something (in other words, not idle).
+//      if we're currently running something (in other words, not idle),
+//	and then only if the scheduler says the time slice is over.
+//
+//	If we are tickless, and no thread is waiting for the CPU, there
+//	is nothing to time slice, so stop the timer until one is.
+//	When idle, the clock then goes straight to the next I/O interrupt.
 //----------------------------------------------------------------------
 
 void 
@@ -49,7 +57,134 @@ Alarm::CallBack()
     Interrupt *interrupt = kernel->interrupt;
     MachineStatus status = interrupt->getStatus();
     
-    if (status != IdleMode) {
+    if (status != IdleMode && kernel->scheduler->TimeSliceExpired()) {
 	interrupt->YieldOnReturn();
     }
+    if (tickless && kernel->scheduler->NumReady() == 0) {
+	DEBUG(dbgInt, "Stopping the timer; nothing to time slice");
+	timer->Stop();
+    }
+}
+
+//----------------------------------------------------------------------
+// Alarm::ThreadReady
+//	Called by the scheduler when a thread is put on the ready list.
+//	If the timer was stopped, start it again, so that the new
+//	thread gets a turn.
+//----------------------------------------------------------------------
+
+void
+Alarm::ThreadReady()
+{
+    if (tickless && timer->IsStopped()) {
+	DEBUG(dbgInt, "Restarting the timer");
+	timer->Start();
+    }
+}
+
+//----------------------------------------------------------------------
+// Alarm::WaitUntil
+//	Suspend the current thread until at least "x" ticks from now.
+//	The thread doesn't use the CPU while it sleeps.
+//
+//	"x" -- how long to sleep; if not positive, return at once
+//----------------------------------------------------------------------
+
+void
+Alarm::WaitUntil(int x)
+{
+    IntStatus oldLevel;
+
+    if (x <= 0) {
+	return;
+    }
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    sleepQueue->Sleep(kernel->stats->totalTicks + x);
+    (void) kernel->interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// WakeCompare
+//	Order sleeping threads by when they are to be woken up.
+//----------------------------------------------------------------------
+
+static int
+WakeCompare(Sleeper *x, Sleeper *y)
+{
+    if (x->when < y->when) { return -1; }
+    else if (x->when > y->when) { return 1; }
+    else { return 0; }
+}
+
+//----------------------------------------------------------------------
+// SleepQueue::SleepQueue
+//	Initialize an empty queue of sleeping threads.
+//----------------------------------------------------------------------
+
+SleepQueue::SleepQueue()
+{
+    sleepers = new SortedList<Sleeper *>(WakeCompare);
+}
+
+//----------------------------------------------------------------------
+// SleepQueue::~SleepQueue
+//	De-allocate the queue.  The Sleepers belong to the threads.
+//----------------------------------------------------------------------
+
+SleepQueue::~SleepQueue()
+{
+    delete sleepers;
+}
+
+//----------------------------------------------------------------------
+// SleepQueue::Sleep
+//	Put the current thread to sleep until "when".  If it is to wake
+//	up before any other sleeping thread, move the wakeup interrupt
+//	earlier.
+//
+//	Called with interrupts disabled; returns once the thread has been
+//	woken up.
+//----------------------------------------------------------------------
+
+void
+SleepQueue::Sleep(long long when)
+{
+    Interrupt *interrupt = kernel->interrupt;
+    Sleeper me;
+
+    ASSERT(interrupt->getLevel() == IntOff);
+    DEBUG(dbgThread, "Sleeping " << kernel->currentThread->getName() << " until " << when);
+
+    me.thread = kernel->currentThread;
+    me.when = when;
+    if (sleepers->IsEmpty() || when < sleepers->Front()->when) {
+	(void) interrupt->Cancel(this, AlarmInt);
+	interrupt->Schedule(this, (int) (when - kernel->stats->totalTicks), 
+								AlarmInt);
+    }
+    sleepers->Insert(&me);
+    kernel->currentThread->Sleep(FALSE);
+}
+
+//----------------------------------------------------------------------
+// SleepQueue::CallBack
+//	Interrupt handler for the wakeup interrupt.  Wake up every thread
+//	whose time has come, then schedule the interrupt for the next one.
+//----------------------------------------------------------------------
+
+void
+SleepQueue::CallBack()
+{
+    long long now = kernel->stats->totalTicks;
+    Sleeper *sleeper;
+
+    while (!sleepers->IsEmpty() && sleepers->Front()->when <= now) {
+	sleeper = sleepers->RemoveFront();
+	DEBUG(dbgThread, "Waking " << sleeper->thread->getName());
+	kernel->scheduler->ReadyToRun(sleeper->thread);
+    }
+    if (!sleepers->IsEmpty()) {
+	kernel->interrupt->Schedule(this, (int) (sleepers->Front()->when - now),
+								AlarmInt);
+    }
 }
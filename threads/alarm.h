@@ -8,7 +8,9 @@
 //	From this, we provide the ability for a thread to be
 //	woken up after a delay; we also provide time-slicing.
 //
-//	NOTE: this abstraction is not completely implemented.
+//	Sleeping threads are woken by an interrupt scheduled for the
+//	earliest wakeup time, rather than by checking on every timer
+//	interrupt, so they are woken at exactly the right time.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -21,19 +23,54 @@
 #include "utility.h"
 #include "callback.h"
 #include "timer.h"
+#include "list.h"
+
+class Thread;
+
+// The following class records a thread sleeping in WaitUntil.  It
+// lives on the sleeping thread's stack.
+
+class Sleeper {
+  public:
+    Thread *thread;		// the sleeping thread
+    long long when;		// when to wake it up
+};
+
+// The following class keeps the sleeping threads, in the order they 
+// are to be woken up.  An interrupt is scheduled for the first of them.
+
+class SleepQueue : public CallBackObj {
+  public:
+    SleepQueue();		// no threads sleeping
+    ~SleepQueue();
+
+    void Sleep(long long when);	// Put the current thread to sleep until 
+				// "when"; called with interrupts disabled
+
+  private:
+    SortedList<Sleeper *> *sleepers;	// soonest wakeup first
+
+    void CallBack();		// Wake up the threads whose time has come
+};
 
 // The following class defines a software alarm clock. 
 class Alarm : public CallBackObj {
   public:
-    Alarm(bool doRandomYield);	// Initialize the timer, and callback 
+    Alarm(bool doRandomYield, bool tickless = FALSE);
+				// Initialize the timer, and callback 
 				// to "toCall" every time slice.
-    ~Alarm() { delete timer; }
+    ~Alarm() { delete timer; delete sleepQueue; }
+
+    void ThreadReady();		// A thread has become ready to run, so
+				// time slicing may be needed again
     
-    void WaitUntil(int x);	// suspend execution until time > now + x
-                                // this method is not yet implemented
+    void WaitUntil(int x);	// suspend execution until time >= now + x
 
   private:
     Timer *timer;		// the hardware timer device
+    bool tickless;		// stop the timer when there is nothing
+				// to time slice
+    SleepQueue *sleepQueue;	// threads in WaitUntil
 
     void CallBack();		// called when the hardware
 				// timer generates an interrupt
@@ -16,6 +16,13 @@
 #include "string.h"
 #include "synchconsole.h"
 #include "synchdisk.h"
+#include "pipe.h"
+#include "usersem.h"
+#include "futex.h"
+#include "synchprofile.h"
+#include "userprofile.h"
+#include "trace.h"
+#include "replay.h"
 #include "post.h"
 
 //----------------------------------------------------------------------
@@ -27,9 +34,20 @@
 Kernel::Kernel(int argc, char **argv)
 {
     randomSlice = FALSE; 
+    tickless = FALSE;
+    schedPolicy = "priority";
+    profileSynch = FALSE;
+    profileInterval = 0;
+    traceFile = NULL;
+    countInstructions = FALSE;
+    replayFile = NULL;
+    replay = FALSE;
+    statsFile = NULL;
+    statsInterval = DefaultSnapshotInterval;
     debugUserProg = FALSE;
     consoleIn = NULL;          // default is stdin
     consoleOut = NULL;         // default is stdout
+    consoleBufferSize = ConsoleBlockSize;
 #ifndef FILESYS_STUB
     formatFlag = FALSE;
 #endif
@@ -43,6 +61,52 @@ Kernel::Kernel(int argc, char **argv)
 					// number generator
 	    randomSlice = TRUE;
 	    i++;
+	} else if (strcmp(argv[i], "-sp") == 0) {
+	    ASSERT(i + 1 < argc);
+	    schedPolicy = argv[i + 1];
+	    i++;
+	} else if (strcmp(argv[i], "-mlfq") == 0) {
+	    schedPolicy = "mlfq";	// same as "-sp mlfq"
+	} else if (strcmp(argv[i], "-ss") == 0) {
+	    ASSERT(i + 1 < argc);   // next argument is int
+	    Thread::SetStackSize(atoi(argv[i + 1]));
+	    i++;
+	} else if (strcmp(argv[i], "-up") == 0) {
+	    profileInterval = DefaultProfileInterval;
+	} else if (strcmp(argv[i], "-upi") == 0) {
+	    ASSERT(i + 1 < argc);   // next argument is int
+	    profileInterval = atoi(argv[i + 1]);
+	    ASSERT(profileInterval > 0);
+	    i++;
+	} else if (strcmp(argv[i], "-tr") == 0) {
+	    ASSERT(i + 1 < argc);
+	    traceFile = argv[i + 1];
+	    i++;
+	} else if (strcmp(argv[i], "-ic") == 0) {
+	    countInstructions = TRUE;
+	} else if (strcmp(argv[i], "-rec") == 0) {
+	    ASSERT(i + 1 < argc);
+	    replayFile = argv[i + 1];
+	    replay = FALSE;
+	    i++;
+	} else if (strcmp(argv[i], "-replay") == 0) {
+	    ASSERT(i + 1 < argc);
+	    replayFile = argv[i + 1];
+	    replay = TRUE;
+	    i++;
+	} else if (strcmp(argv[i], "-so") == 0) {
+	    ASSERT(i + 1 < argc);
+	    statsFile = argv[i + 1];
+	    i++;
+	} else if (strcmp(argv[i], "-si") == 0) {
+	    ASSERT(i + 1 < argc);   // next argument is int
+	    statsInterval = atoi(argv[i + 1]);
+	    ASSERT(statsInterval > 0);
+	    i++;
+	} else if (strcmp(argv[i], "-tl") == 0) {
+	    tickless = TRUE;
+	} else if (strcmp(argv[i], "-cs") == 0) {
+	    profileSynch = TRUE;
         } else if (strcmp(argv[i], "-s") == 0) {
             debugUserProg = TRUE;
 	} else if (strcmp(argv[i], "-ci") == 0) {
@@ -53,6 +117,12 @@ Kernel::Kernel(int argc, char **argv)
 	    ASSERT(i + 1 < argc);
 	    consoleOut = argv[i + 1];
 	    i++;
+	} else if (strcmp(argv[i], "-cb") == 0) {
+	    ASSERT(i + 1 < argc);   // next argument is int
+	    consoleBufferSize = atoi(argv[i + 1]);
+	    ASSERT(consoleBufferSize > 0 && 
+			consoleBufferSize <= ConsoleBlockSize);
+	    i++;
 #ifndef FILESYS_STUB
 	} else if (strcmp(argv[i], "-f") == 0) {
 	    formatFlag = TRUE;
@@ -68,7 +138,17 @@ Kernel::Kernel(int argc, char **argv)
         } else if (strcmp(argv[i], "-u") == 0) {
             std::cout << "Partial usage: nachos [-rs randomSeed]\n";
 	    std::cout << "Partial usage: nachos [-s]\n";
+	    std::cout << "Partial usage: nachos [-sp priority|mlfq|stride]\n";
+	    std::cout << "Partial usage: nachos [-mlfq]\n";
+	    std::cout << "Partial usage: nachos [-ss stackSize]\n";
+	    std::cout << "Partial usage: nachos [-cs]\n";
+	    std::cout << "Partial usage: nachos [-tl]\n";
+	    std::cout << "Partial usage: nachos [-so statsFile] [-si interval]\n";
+	    std::cout << "Partial usage: nachos [-up] [-upi interval]\n";
+	    std::cout << "Partial usage: nachos [-tr traceFile] [-ic]\n";
+	    std::cout << "Partial usage: nachos [-rec logFile | -replay logFile]\n";
             std::cout << "Partial usage: nachos [-ci consoleIn] [-co consoleOut]\n";
+            std::cout << "Partial usage: nachos [-cb consoleBufferSize]\n";
 #ifndef FILESYS_STUB
 	    std::cout << "Partial usage: nachos [-nf]\n";
 #endif
@@ -87,6 +167,23 @@ Kernel::Kernel(int argc, char **argv)
 void
 Kernel::Initialize()
 {
+    synchProfiler = NULL;
+    if (profileSynch) {
+	synchProfiler = new SynchProfiler();	// count lock contention
+    }
+    userProfiler = NULL;
+    if (profileInterval > 0) {
+	userProfiler = new UserProfiler(profileInterval);
+    }
+    traceWriter = NULL;
+    if (traceFile != NULL) {
+	traceWriter = new TraceWriter(traceFile);
+    }
+    instrCounter = NULL;
+    if (countInstructions) {
+	instrCounter = new InstructionCounter();
+    }
+
     // We didn't explicitly allocate the current thread we are running in.
     // But if it ever tries to give up the CPU, we better have a Thread
     // object to save its state. 
@@ -94,12 +191,22 @@ Kernel::Initialize()
     currentThread->setStatus(RUNNING);
 
     stats = new Statistics();		// collect statistics
+    if (statsFile != NULL) {
+	stats->Export(statsFile, statsInterval);
+    }
+    replayLog = NULL;
+    if (replayFile != NULL) {		// before any device starts up
+	replayLog = new ReplayLog(replayFile, replay);
+    }
     interrupt = new Interrupt;		// start up interrupt handling
-    scheduler = new Scheduler();	// initialize the ready queue
-    alarm = new Alarm(randomSlice);	// start up time slicing
+    scheduler = new Scheduler(schedPolicy);	// initialize the ready queue
+    alarm = new Alarm(randomSlice, tickless);
+					// start up time slicing
     machine = new Machine(debugUserProg);
-    synchConsoleIn = new SynchConsoleInput(consoleIn); // input from stdin
-    synchConsoleOut = new SynchConsoleOutput(consoleOut); // output to stdout
+    synchConsoleIn = new SynchConsoleInput(consoleIn, consoleBufferSize);
+						// input from stdin
+    synchConsoleOut = new SynchConsoleOutput(consoleOut, consoleBufferSize);
+						// output to stdout
     synchDisk = new SynchDisk();    //
 #ifdef FILESYS_STUB
     fileSystem = new FileSystem();
@@ -108,6 +215,9 @@ Kernel::Initialize()
 #endif // FILESYS_STUB
     postOfficeIn = new PostOfficeInput(10);
     postOfficeOut = new PostOfficeOutput(reliability);
+    pipeTable = new PipeTable();
+    userSemaphores = new UserSemaphoreTable();
+    futexTable = new FutexTable();
 
     interrupt->Enable();
 }
@@ -119,6 +229,29 @@ Kernel::Initialize()
 
 Kernel::~Kernel()
 {
+    if (synchProfiler != NULL) {
+	synchProfiler->Print();
+	delete synchProfiler;
+	synchProfiler = NULL;
+    }
+    if (userProfiler != NULL) {
+	userProfiler->Print();
+	delete userProfiler;
+	userProfiler = NULL;
+    }
+    if (traceWriter != NULL) {
+	delete traceWriter;		// write out the rest of the trace
+	traceWriter = NULL;
+    }
+    if (instrCounter != NULL) {
+	instrCounter->Print();
+	delete instrCounter;
+	instrCounter = NULL;
+    }
+    if (replayLog != NULL) {
+	delete replayLog;		// write out the rest of the log
+	replayLog = NULL;
+    }
     delete stats;
     delete interrupt;
     delete scheduler;
@@ -130,19 +263,26 @@ Kernel::~Kernel()
     delete fileSystem;
     delete postOfficeIn;
     delete postOfficeOut;
+    delete pipeTable;
+    delete userSemaphores;
+    delete futexTable;
+    Thread::FreeStacks();
     
     Exit(0);
 }
 
 //----------------------------------------------------------------------
 // Kernel::ThreadSelfTest
-//      Test threads, semaphores, synchlists
+//      Test threads, semaphores, synchlists, reader-writer locks
+//	and barriers
 //----------------------------------------------------------------------
 
 void
 Kernel::ThreadSelfTest() {
    Semaphore *semaphore;
    SynchList<int> *synchList;
+   RWLock *rwlock;
+   Barrier *barrier;
    
    LibSelfTest();		// test library routines
    
@@ -159,6 +299,16 @@ Kernel::ThreadSelfTest() {
    synchList->SelfTest(9);
    delete synchList;
 
+   				// test reader-writer locks
+   rwlock = new RWLock("test");
+   rwlock->SelfTest();
+   delete rwlock;
+
+   				// test barriers
+   barrier = new Barrier("test", 3);
+   barrier->SelfTest();
+   delete barrier;
+
 }
 
 //----------------------------------------------------------------------
@@ -179,6 +329,7 @@ Kernel::ConsoleTest() {
         ch = synchConsoleIn->GetChar();
         if(ch != EOF) synchConsoleOut->PutChar(ch);   // echo it!
     } while (ch != EOF);
+    synchConsoleOut->Flush();	// echo any unterminated last line
 
     std::cout << "\n";
 
@@ -24,6 +24,14 @@ class PostOfficeOutput;
 class SynchConsoleInput;
 class SynchConsoleOutput;
 class SynchDisk;
+class PipeTable;
+class UserSemaphoreTable;
+class FutexTable;
+class SynchProfiler;
+class UserProfiler;
+class TraceWriter;
+class InstructionCounter;
+class ReplayLog;
 
 class Kernel {
   public:
@@ -56,15 +64,42 @@ class Kernel {
     FileSystem *fileSystem;     
     PostOfficeInput *postOfficeIn;
     PostOfficeOutput *postOfficeOut;
+    PipeTable *pipeTable;	// pipes open between user programs
+    UserSemaphoreTable *userSemaphores; // semaphores for user programs
+    FutexTable *futexTable;	// user threads waiting on user memory
+    SynchProfiler *synchProfiler; // contention counters; NULL unless
+				// profiling synchronization
+    UserProfiler *userProfiler;	// samples of user program counters;
+				// NULL unless profiling user programs
+    TraceWriter *traceWriter;	// binary trace of user instructions;
+				// NULL unless tracing
+    InstructionCounter *instrCounter; // counts of user instructions,
+				// branches and blocks; NULL unless counting
+    ReplayLog *replayLog;	// external events being recorded or
+				// replayed; NULL unless doing either
 
     int hostName;               // machine identifier
 
   private:
     bool randomSlice;		// enable pseudo-random time slicing
+    bool tickless;		// stop the timer when nothing is waiting
+				// for the CPU
+    const char *schedPolicy;		// name of the scheduling policy
+    bool profileSynch;		// profile synchronization contention
+    int profileInterval;	// user instructions between profile
+				// samples; 0 if not profiling
+    bool countInstructions;	// count user instructions
+    char *replayFile;		// log of external events, or NULL
+    bool replay;		// replay the log, rather than record it
+    char *traceFile;		// file to trace user instructions to,
+				// or NULL
+    char *statsFile;		// file to export statistics to, or NULL
+    int statsInterval;		// ticks between exported snapshots
     bool debugUserProg;         // single step user program
     double reliability;         // likelihood messages are dropped
     char *consoleIn;            // file to read console input from
     char *consoleOut;           // file to send console output to
+    int consoleBufferSize;      // chars per console transfer
 #ifndef FILESYS_STUB
     bool formatFlag;          // format the disk if this is true
 #endif
@@ -2,15 +2,37 @@
 //	Driver code to initialize, selftest, and run the 
 //	operating system kernel.  
 //
-// Usage: nachos -d <debugflags> -rs <random seed #>
+// Usage: nachos -d <debugflags> -rs <random seed #> -sp <policy> -ss # -cs -tl
+//              -so <stats file> -si # -up -upi # -tr <trace file> -ic
+//              -rec <log file> -replay <log file>
 //              -s -x <nachos file> -ci <consoleIn> -co <consoleOut>
 //              -f -cp <unix file> <nachos file>
 //              -p <nachos file> -r <nachos file> -l -D
 //              -n <network reliability> -m <machine id>
-//              -z -K -C -N
+//              -z -K -C -N -bench threads -ta <trace file>
 //
 //    -d causes certain debugging messages to be printed (see debug.h)
 //    -rs causes Yield to occur at random (but repeatable) spots
+//    -sp sets the scheduling policy: priority (the default), mlfq
+//	(multi-level feedback) or stride (proportional share)
+//    -mlfq is short for "-sp mlfq"
+//    -ss sets the size of thread stacks, in words
+//    -cs prints a report of contention on locks, semaphores and
+//	condition variables when Nachos halts
+//    -tl stops the timer while no thread is waiting for the CPU
+//    -so exports snapshots of the statistics to a file, in CSV if its
+//	name ends in .csv and in JSON otherwise; -si sets the number of
+//	ticks between snapshots
+//    -up profiles user programs, sampling the PC every 100 instructions
+//	(-upi sets how many), and reports the hot spots when Nachos halts
+//    -tr writes a binary trace of the instructions user programs run
+//	to a file
+//    -ic counts user instructions by opcode, branches by whether they
+//	were taken, and basic blocks, and prints the counts when Nachos
+//	halts
+//    -rec logs when console input and packets arrive, what they hold,
+//	and the random numbers used; -replay repeats a run exactly from
+//	such a log (see replay.h)
 //    -z prints the copyright message
 //    -s causes user programs to be executed in single-step mode
 //    -x runs a user program
@@ -21,6 +43,10 @@
 //    -K run a simple self test of kernel threads and synchronization
 //    -C run an interactive console test
 //    -N run a two-machine network test (see Kernel::NetworkTest)
+//    -bench threads times context switches, thread creation and
+//	synchronization (see threadbench.cc)
+//    -ta reports the instruction mix, memory reuse distances and
+//	working set of pages of a trace written with -tr (see trace.cc)
 //
 //    Filesystem-related flags:
 //    -f forces the Nachos disk to be formatted
@@ -45,6 +71,9 @@
 #include "filesys.h"
 #include "openfile.h"
 #include "sysdep.h"
+#include "threadbench.h"
+#include "userprofile.h"
+#include "trace.h"
 
 #ifdef TUT
 
@@ -185,6 +214,8 @@ main(int argc, char **argv)
     bool threadTestFlag = false;
     bool consoleTestFlag = false;
     bool networkTestFlag = false;
+    bool threadBenchFlag = false;
+    char *traceAnalyzeFile = NULL;    // trace to report on, if any
 #ifndef FILESYS_STUB
     char *copyUnixFileName = NULL;    // UNIX file to be copied into Nachos
     char *copyNachosFileName = NULL;  // name of copied file in Nachos
@@ -220,6 +251,17 @@ main(int argc, char **argv)
 	else if (strcmp(argv[i], "-N") == 0) {
 	    networkTestFlag = TRUE;
 	}
+	else if (strcmp(argv[i], "-bench") == 0) {
+	    ASSERT(i + 1 < argc);
+	    ASSERT(strcmp(argv[i + 1], "threads") == 0);
+	    threadBenchFlag = TRUE;
+	    i++;
+	}
+	else if (strcmp(argv[i], "-ta") == 0) {
+	    ASSERT(i + 1 < argc);
+	    traceAnalyzeFile = argv[i + 1];
+	    i++;
+	}
 #ifndef FILESYS_STUB
 	else if (strcmp(argv[i], "-cp") == 0) {
 	    ASSERT(i + 2 < argc);
@@ -248,6 +290,8 @@ main(int argc, char **argv)
             std::cout << "Partial usage: nachos [-z -d debugFlags]\n";
             std::cout << "Partial usage: nachos [-x programName]\n";
 	    std::cout << "Partial usage: nachos [-K] [-C] [-N]\n";
+	    std::cout << "Partial usage: nachos [-bench threads]\n";
+	    std::cout << "Partial usage: nachos [-ta traceFile]\n";
 #ifndef FILESYS_STUB
             std::cout << "Partial usage: nachos [-cp UnixFile NachosFile]\n";
             std::cout << "Partial usage: nachos [-p fileName] [-r fileName]\n";
@@ -283,6 +327,12 @@ main(int argc, char **argv)
     if (networkTestFlag) {
       kernel->NetworkTest();   // two-machine test of the network
     }
+    if (threadBenchFlag) {
+      ThreadBenchmark();       // time the threading core
+    }
+    if (traceAnalyzeFile != NULL) {
+      AnalyzeTrace(traceAnalyzeFile); // report on an instruction trace
+    }
 
 #ifndef FILESYS_STUB
     if (removeFileName != NULL) {
@@ -307,6 +357,9 @@ main(int argc, char **argv)
       AddrSpace *space = new AddrSpace;
       ASSERT(space != (AddrSpace *)NULL);
       if (space->Load(userProgName)) {  // load the program into the space
+	if (kernel->userProfiler != NULL) {
+	  kernel->userProfiler->LoadSymbols(userProgName);
+	}
 	space->Execute();              // run the program
 	ASSERTNOTREACHED();            // Execute never returns
       }
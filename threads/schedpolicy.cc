@@ -0,0 +1,380 @@
+// schedpolicy.cc
+//	Routines for the scheduling policies: strict priority,
+//	multi-level feedback, and stride scheduling.
+//
+//	These routines assume that interrupts are already disabled,
+//	as for the Scheduler itself.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "schedpolicy.h"
+#include "main.h"
+
+// How often every thread is boosted back to the top feedback level
+const int FeedbackBoostTicks = 50 * TimerTicks;
+
+//----------------------------------------------------------------------
+// SchedulerPolicy::Create
+// 	Return a new scheduling policy.
+//
+//	"name" -- "priority", "mlfq" or "stride"
+//----------------------------------------------------------------------
+
+SchedulerPolicy *
+SchedulerPolicy::Create(const char *name)
+{
+    if (strcmp(name, "priority") == 0) {
+	return new PriorityPolicy();
+    } else if (strcmp(name, "mlfq") == 0) {
+	return new FeedbackPolicy();
+    } else if (strcmp(name, "stride") == 0) {
+	return new StridePolicy();
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::PriorityPolicy
+// 	Initialize the ready queues, all empty.
+//----------------------------------------------------------------------
+
+PriorityPolicy::PriorityPolicy()
+{
+    for (int i = 0; i < NumPriorities; i++) {
+	readyList[i] = new List<Thread *>;
+    }
+    readyMask = 0;
+    numReady = 0;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::~PriorityPolicy
+// 	De-allocate the ready queues.
+//----------------------------------------------------------------------
+
+PriorityPolicy::~PriorityPolicy()
+{
+    for (int i = 0; i < NumPriorities; i++) {
+	delete readyList[i];
+    }
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::Enqueue
+// 	Put a thread on the end of the queue for its scheduling priority.
+//----------------------------------------------------------------------
+
+void
+PriorityPolicy::Enqueue(Thread *thread)
+{
+    int priority = thread->getSchedulingPriority();
+
+    ASSERT(priority >= 0 && priority < NumPriorities);
+    readyList[priority]->Append(thread);
+    readyMask |= (1 << priority);
+    numReady++;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::PickNext
+// 	Take the thread that has waited longest at the highest priority
+//	off its queue.  If there are no ready threads, return NULL.
+//----------------------------------------------------------------------
+
+Thread *
+PriorityPolicy::PickNext()
+{
+    int priority;
+    Thread *thread;
+
+    if (readyMask == 0) {
+	return NULL;
+    }
+    priority = highestBit(readyMask);	// highest non-empty level
+    thread = readyList[priority]->RemoveFront();
+    if (readyList[priority]->IsEmpty()) {
+	readyMask &= ~(1 << priority);
+    }
+    numReady--;
+    return thread;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::Remove
+// 	Take a ready thread off its queue, out of turn.  Its scheduling
+//	priority must not have changed since it was enqueued.
+//----------------------------------------------------------------------
+
+void
+PriorityPolicy::Remove(Thread *thread)
+{
+    int priority = thread->getSchedulingPriority();
+
+    readyList[priority]->Remove(thread);
+    if (readyList[priority]->IsEmpty()) {
+	readyMask &= ~(1 << priority);
+    }
+    numReady--;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::Print
+// 	Print the ready threads, highest priority first.
+//----------------------------------------------------------------------
+
+void
+PriorityPolicy::Print()
+{
+    for (int i = NumPriorities - 1; i >= 0; i--) {
+	readyList[i]->Apply(ThreadPrint);
+    }
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::FeedbackPolicy
+// 	Initialize multi-level feedback scheduling.  The first boost
+//	is due after one boost interval.
+//----------------------------------------------------------------------
+
+FeedbackPolicy::FeedbackPolicy()
+{
+    boostEpoch = 0;
+    nextBoost = FeedbackBoostTicks;
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::Enqueue
+// 	Put a thread on the queue for its feedback level.  A thread
+//	that is new, or that has missed a boost while it was blocked,
+//	starts over at the top level.
+//----------------------------------------------------------------------
+
+void
+FeedbackPolicy::Enqueue(Thread *thread)
+{
+    if (thread->boostEpoch != boostEpoch) {
+	thread->setEffectivePriority(TopFeedbackLevel);
+	thread->sliceTicks = 0;
+	thread->boostEpoch = boostEpoch;
+    }
+    PriorityPolicy::Enqueue(thread);
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::Charge
+// 	Count CPU time against a thread's quantum.
+//----------------------------------------------------------------------
+
+void
+FeedbackPolicy::Charge(Thread *thread, int ticks)
+{
+    thread->sliceTicks += ticks;
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::OnTick
+// 	A thread runs until it has used the quantum of its level (and
+//	is demoted), or until a thread at a higher level is ready.
+//----------------------------------------------------------------------
+
+bool
+FeedbackPolicy::OnTick(Thread *thread)
+{
+    int level;
+
+    if (kernel->stats->totalTicks >= nextBoost) {
+	Boost(thread);
+	return TRUE;
+    }
+    level = thread->getEffectivePriority();
+    if (thread->sliceTicks >= Quantum(level)) {
+	if (level > BottomFeedbackLevel) {
+	    DEBUG(dbgThread, "Demoting thread: " << thread->getName());
+	    thread->setEffectivePriority(level - 1);
+	}
+	thread->sliceTicks = 0;
+	return TRUE;
+    }
+    level = thread->getSchedulingPriority();
+    return ((readyMask >> (level + 1)) != 0);	// preempted by a higher
+						// level?
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::OnBlock
+// 	A thread that blocks before using up its quantum rises a level.
+//----------------------------------------------------------------------
+
+void
+FeedbackPolicy::OnBlock(Thread *thread)
+{
+    int level = thread->getEffectivePriority();
+
+    if (level < TopFeedbackLevel && thread->sliceTicks < Quantum(level)) {
+	DEBUG(dbgThread, "Promoting thread: " << thread->getName());
+	thread->setEffectivePriority(level + 1);
+    }
+    thread->sliceTicks = 0;
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::Quantum
+// 	Return the time slice for a feedback level: one timer interval
+//	at the top level, doubling at each level below it.
+//----------------------------------------------------------------------
+
+int
+FeedbackPolicy::Quantum(int level)
+{
+    ASSERT(level >= BottomFeedbackLevel && level <= TopFeedbackLevel);
+    return TimerTicks << (TopFeedbackLevel - level);
+}
+
+//----------------------------------------------------------------------
+// FeedbackPolicy::Boost
+// 	Move every thread back to the top feedback level, so that
+//	threads that have sunk to the bottom do not starve.  Ready
+//	threads are moved now, keeping their order; blocked threads
+//	notice the boost when they are next put on the ready list.
+//
+//	"current" -- the running thread
+//----------------------------------------------------------------------
+
+void
+FeedbackPolicy::Boost(Thread *current)
+{
+    Thread *thread;
+
+    DEBUG(dbgThread, "Boosting all threads to the top feedback level");
+    boostEpoch++;
+    nextBoost = kernel->stats->totalTicks + FeedbackBoostTicks;
+
+    for (int i = TopFeedbackLevel - 1; i >= BottomFeedbackLevel; i--) {
+	while (!readyList[i]->IsEmpty()) {
+	    readyList[TopFeedbackLevel]->Append(readyList[i]->RemoveFront());
+	}
+    }
+    readyMask &= ~(((1 << NumFeedbackLevels) - 1) << BottomFeedbackLevel);
+    if (!readyList[TopFeedbackLevel]->IsEmpty()) {
+	readyMask |= (1 << TopFeedbackLevel);
+    }
+
+    ListIterator<Thread *> iter(readyList[TopFeedbackLevel]);
+    for (; !iter.IsDone(); iter.Next()) {
+	thread = iter.Item();
+	thread->setEffectivePriority(TopFeedbackLevel);
+	thread->sliceTicks = 0;
+	thread->boostEpoch = boostEpoch;
+    }
+
+    current->setEffectivePriority(TopFeedbackLevel);
+    current->sliceTicks = 0;
+    current->boostEpoch = boostEpoch;
+}
+
+//----------------------------------------------------------------------
+// PassCompare
+// 	Compare two threads by pass, for the stride ready list.  Passes
+//	are allowed to wrap around, so compare their difference.
+//----------------------------------------------------------------------
+
+static int
+PassCompare(Thread *x, Thread *y)
+{
+    return (int) (x->pass - y->pass);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::StridePolicy
+// 	Initialize stride scheduling, with no ready threads.
+//----------------------------------------------------------------------
+
+StridePolicy::StridePolicy()
+{
+    readyList = new SortedList<Thread *>(PassCompare);
+    globalPass = 0;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::~StridePolicy
+// 	De-allocate the ready list.
+//----------------------------------------------------------------------
+
+StridePolicy::~StridePolicy()
+{
+    delete readyList;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Stride
+// 	Return how far a thread's pass advances per tick: the inverse
+//	of its tickets, which are one more than its scheduling priority.
+//----------------------------------------------------------------------
+
+unsigned int
+StridePolicy::Stride(Thread *thread)
+{
+    return StrideOne / (thread->getSchedulingPriority() + 1);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Enqueue
+// 	Put a thread on the ready list, in order of pass.  A thread
+//	that is new, or has been blocked, can't have a pass behind the
+//	others -- it would otherwise get back all the CPU time it didn't
+//	use while it wasn't ready.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Enqueue(Thread *thread)
+{
+    if ((int) (thread->pass - globalPass) < 0) {
+	thread->pass = globalPass;
+    }
+    readyList->Insert(thread);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::PickNext
+// 	Take the ready thread with the lowest pass off the ready list.
+//	If there are no ready threads, return NULL.
+//----------------------------------------------------------------------
+
+Thread *
+StridePolicy::PickNext()
+{
+    Thread *thread;
+
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    thread = readyList->RemoveFront();
+    globalPass = thread->pass;
+    return thread;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Charge
+// 	Advance a thread's pass for the CPU time it has used.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Charge(Thread *thread, int ticks)
+{
+    thread->pass += Stride(thread) * ticks;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Print
+// 	Print the ready threads, lowest pass first.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Print()
+{
+    readyList->Apply(ThreadPrint);
+}
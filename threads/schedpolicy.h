@@ -0,0 +1,141 @@
+// schedpolicy.h
+//	Data structures for scheduling policies -- the part of the
+//	scheduler that decides which ready thread runs next, and for
+//	how long.
+//
+//	The Scheduler does the dispatching, and tells its policy about
+//	the events that matter to it: a thread becoming ready, the CPU
+//	time a thread has used, a timer interrupt, a thread blocking.
+//	The policy is chosen when Nachos boots (see Kernel::Kernel).
+//
+//	All of these routines are called with interrupts disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SCHEDPOLICY_H
+#define SCHEDPOLICY_H
+
+#include "copyright.h"
+#include "list.h"
+#include "thread.h"
+
+// The following class defines the interface every scheduling policy
+// provides to the Scheduler.
+
+class SchedulerPolicy {
+  public:
+    virtual ~SchedulerPolicy() {}
+
+    virtual void Enqueue(Thread *thread) = 0;
+				// "thread" is ready to run
+    virtual Thread *PickNext() = 0;
+				// Dequeue the thread to run next;
+				// NULL if there are none
+    virtual void Remove(Thread *thread) = 0;
+				// Dequeue "thread", which is ready
+    virtual void Charge(Thread *thread, int ticks) {}
+				// "thread" has used "ticks" more of
+				// the CPU
+    virtual bool OnTick(Thread *thread) = 0;
+				// Timer interrupt while "thread" is
+				// running; should it yield?
+    virtual void OnBlock(Thread *thread) {}
+				// "thread" has given up the CPU to wait
+    virtual int NumReady() = 0;	// How many threads are ready?
+    virtual void Print() = 0;	// Print the ready threads
+
+    static SchedulerPolicy *Create(const char *name);
+				// Return a new policy, by name; NULL
+				// if there is no such policy
+};
+
+// Strict priority scheduling: the ready thread with the highest
+// (scheduling) priority runs, FIFO among threads of equal priority.
+// There is one ready queue per priority level, plus a bitmask of
+// the levels that have ready threads, so that both enqueueing a thread
+// and picking the next one take constant time.
+
+class PriorityPolicy : public SchedulerPolicy {
+  public:
+    PriorityPolicy();		// no ready threads yet
+    ~PriorityPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *PickNext();		// front of the highest non-empty queue
+    void Remove(Thread *thread);
+    bool OnTick(Thread *thread) { return TRUE; }
+				// every timer interrupt ends a slice
+    int NumReady() { return numReady; }
+    void Print();
+
+  protected:
+    List<Thread *> *readyList[NumPriorities];
+				// queues of threads that are ready to run,
+				// but not running; one FIFO per priority
+    unsigned int readyMask;	// bit i is set iff readyList[i] is
+				// not empty
+    int numReady;		// threads on all the queues
+};
+
+// Multi-level feedback scheduling: threads are queued by a feedback
+// level instead of by their own priority.  Threads start at the top
+// level; one that uses up its quantum drops a level, and one that
+// blocks before then rises a level.  Lower levels get longer quanta.
+// Every so often, all threads are moved back to the top, so that
+// none of them starve.
+
+const int NumFeedbackLevels = 4;	// priorities used by the feedback
+					// levels, counting down from the top
+const int TopFeedbackLevel = NumPriorities - 1;
+const int BottomFeedbackLevel = NumPriorities - NumFeedbackLevels;
+
+class FeedbackPolicy : public PriorityPolicy {
+  public:
+    FeedbackPolicy();
+
+    void Enqueue(Thread *thread);
+    void Charge(Thread *thread, int ticks);
+    bool OnTick(Thread *thread);	// quantum used up, or preempted?
+    void OnBlock(Thread *thread);	// rise a level if it blocked early
+
+  private:
+    int boostEpoch;		// number of priority boosts so far
+    long long nextBoost;	// when to do the next one
+
+    int Quantum(int level);	// time slice for a feedback level
+    void Boost(Thread *current);// move every thread back to the top
+};
+
+// Stride scheduling, for proportional sharing of the CPU.  Each
+// thread holds tickets -- one more than its scheduling priority, so
+// that inherited priority counts -- and gets CPU
+// time in proportion to them.  A thread's "pass" advances by its
+// stride (inversely proportional to its tickets) for each tick it
+// runs; the ready thread with the lowest pass runs next.
+
+const unsigned int StrideOne = (1 << 10);	// stride of one ticket
+
+class StridePolicy : public SchedulerPolicy {
+  public:
+    StridePolicy();
+    ~StridePolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *PickNext();		// ready thread with the lowest pass
+    void Remove(Thread *thread) { readyList->Remove(thread); }
+    void Charge(Thread *thread, int ticks);
+    bool OnTick(Thread *thread) { return TRUE; }
+				// decide again on every timer interrupt
+    int NumReady() { return readyList->NumInList(); }
+    void Print();
+
+  private:
+    SortedList<Thread *> *readyList;	// ready threads, by pass
+    unsigned int globalPass;	// pass of the last thread picked
+
+    static unsigned int Stride(Thread *thread);
+};
+
+#endif // SCHEDPOLICY_H
@@ -11,8 +11,10 @@
 //	end up calling FindNextToRun(), and that would put us in an 
 //	infinite loop.
 //
-// 	Very simple implementation -- no priorities, straight FIFO.
-//	Might need to be improved in later assignments.
+// 	Which thread runs next, and for how long, is up to a scheduling
+//	policy (see schedpolicy.h), chosen when Nachos boots.  The
+//	default is strict priority scheduling, FIFO among threads of
+//	equal priority.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -27,11 +29,16 @@
 // Scheduler::Scheduler
 // 	Initialize the list of ready but not running threads.
 //	Initially, no ready threads.
+//
+//	"policyName" -- the scheduling policy to use; see 
+//		SchedulerPolicy::Create
 //----------------------------------------------------------------------
 
-Scheduler::Scheduler()
+Scheduler::Scheduler(const char *policyName)
 { 
-    readyList = new List<Thread *>; 
+    policy = SchedulerPolicy::Create(policyName);
+    ASSERT(policy != NULL);
+    switches = kernel->stats->RegisterCounter("contextSwitches");
     toBeDestroyed = NULL;
 } 
 
@@ -42,7 +49,7 @@ Scheduler::Scheduler()
 
 Scheduler::~Scheduler()
 { 
-    delete readyList; 
+    delete policy; 
 } 
 
 //----------------------------------------------------------------------
@@ -60,12 +67,26 @@ Scheduler::ReadyToRun (Thread *thread)
     DEBUG(dbgThread, "Putting thread on ready list: " << thread->getName());
 
     thread->setStatus(READY);
-    readyList->Append(thread);
+    policy->Enqueue(thread);
+    kernel->alarm->ThreadReady();
+}
+
+//----------------------------------------------------------------------
+// Scheduler::NumReady
+// 	Return the number of threads that are ready to run, but not
+//	running.
+//----------------------------------------------------------------------
+
+int
+Scheduler::NumReady()
+{
+    return policy->NumReady();
 }
 
 //----------------------------------------------------------------------
 // Scheduler::FindNextToRun
-// 	Return the next thread to be scheduled onto the CPU.
+// 	Return the next thread to be scheduled onto the CPU, as chosen
+//	by the scheduling policy.
 //	If there are no ready threads, return NULL.
 // Side effect:
 //	Thread is removed from the ready list.
@@ -74,24 +95,9 @@ Scheduler::ReadyToRun (Thread *thread)
 Thread *
 Scheduler::FindNextToRun ()
 {
-	int highestPriority = -1;
-	Thread* highestThread;
     ASSERT(kernel->interrupt->getLevel() == IntOff);
 
-    if (readyList->IsEmpty()) {
-    	return NULL;
-    } else {
-    	ListIterator<Thread* >*  iterator = new ListIterator<Thread* >(readyList);
-    	while (!iterator->IsDone()) {
-    		if (iterator->Item()->getPriority() > highestPriority) {
-    			highestThread = iterator->Item();
-    			highestPriority = highestThread->getPriority();
-    		}
-    		iterator->Next();
-    	}
-    	readyList->Remove(highestThread);
-    	return highestThread;
-    }
+    return policy->PickNext();
 }
 
 //----------------------------------------------------------------------
@@ -122,6 +128,11 @@ Scheduler::Run (Thread *nextThread, bool finishing)
          ASSERT(toBeDestroyed == NULL);
          toBeDestroyed = oldThread;
     }
+
+    Charge(oldThread);
+    if (!finishing && oldThread->getStatus() == BLOCKED) {
+	policy->OnBlock(oldThread);
+    }
     
     if (oldThread->space != NULL) {	// if this thread is a user program,
         oldThread->SaveUserState(); 	// save the user's CPU registers
@@ -131,8 +142,10 @@ Scheduler::Run (Thread *nextThread, bool finishing)
     oldThread->CheckOverflow();		    // check if the old thread
 					    // had an undetected stack overflow
 
+    switches->Add();
     kernel->currentThread = nextThread;  // switch to the next thread
     nextThread->setStatus(RUNNING);      // nextThread is now running
+    nextThread->sliceStart = kernel->stats->totalTicks;
     
     DEBUG(dbgThread, "Switching from: " << oldThread->getName() << " to: " << nextThread->getName());
     
@@ -177,6 +190,65 @@ Scheduler::CheckToBeDestroyed()
     }
 }
  
+//----------------------------------------------------------------------
+// Scheduler::TimeSliceExpired
+// 	Called by the alarm on each timer interrupt, with interrupts
+//	disabled.  Charge the current thread for the CPU time it has
+//	used, and let the scheduling policy decide whether it should 
+//	give up the CPU.
+//----------------------------------------------------------------------
+
+bool
+Scheduler::TimeSliceExpired()
+{
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+
+    Charge(kernel->currentThread);
+    return policy->OnTick(kernel->currentThread);
+}
+
+//----------------------------------------------------------------------
+// Scheduler::SetInheritedPriority
+// 	Change the priority a thread has inherited from the threads
+//	waiting for its locks.  If the thread is on a ready list, it is
+//	taken off and put back, so that it is queued at its new 
+//	scheduling priority.
+//
+//	"thread" -- the thread whose priority changes
+//	"priority" -- the inherited priority, or -1 for none
+//----------------------------------------------------------------------
+
+void
+Scheduler::SetInheritedPriority(Thread *thread, int priority)
+{
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    ASSERT(priority >= -1 && priority < NumPriorities);
+
+    if (thread->getStatus() == READY) {
+	policy->Remove(thread);
+	thread->setInheritedPriority(priority);
+	policy->Enqueue(thread);
+    } else {
+	thread->setInheritedPriority(priority);
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::Charge
+// 	Tell the scheduling policy how much CPU time a thread has used
+//	since it was last charged -- either since it was dispatched, or
+//	since the last timer interrupt.
+//----------------------------------------------------------------------
+
+void
+Scheduler::Charge(Thread *thread)
+{
+    long long now = kernel->stats->totalTicks;
+
+    policy->Charge(thread, (int) (now - thread->sliceStart));
+    thread->sliceStart = now;
+}
+
 //----------------------------------------------------------------------
 // Scheduler::Print
 // 	Print the scheduler state -- in other words, the contents of
@@ -186,6 +258,6 @@ void
 Scheduler::Print()
 {
     cout << "Ready list contents:\n";
-    readyList->Apply(ThreadPrint);
+    policy->Print();
 }
 
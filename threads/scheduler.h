@@ -12,6 +12,8 @@
 #include "copyright.h"
 #include "list.h"
 #include "thread.h"
+#include "schedpolicy.h"
+#include "stats.h"
 
 // The following class defines the scheduler/dispatcher abstraction -- 
 // the data structures and operations needed to keep track of which 
@@ -19,7 +21,9 @@
 
 class Scheduler {
   public:
-    Scheduler();		// Initialize list of ready threads 
+    Scheduler(const char *policyName = "priority");
+				// Initialize list of ready threads, 
+				// to be scheduled by the named policy
     ~Scheduler();		// De-allocate ready list
 
     void ReadyToRun(Thread* thread);	
@@ -30,15 +34,26 @@ class Scheduler {
     				// Cause nextThread to start running
     void CheckToBeDestroyed();// Check if thread that had been
     				// running needs to be deleted
+    bool TimeSliceExpired();	// Called on each timer interrupt; 
+				// should the current thread yield?
+    int NumReady();		// How many threads are ready?
+    void SetInheritedPriority(Thread *thread, int priority);
+				// Change the priority "thread" has
+				// inherited, requeueing it if ready
     void Print();		// Print contents of ready list
     
     // SelfTest for scheduler is implemented in class Thread
     
   private:
-    List<Thread *> *readyList;  // queue of threads that are ready to run,
-				// but not running
+    SchedulerPolicy *policy;	// keeps the threads that are ready to
+				// run, but not running, and decides
+				// which runs next
+    StatCounter *switches;	// number of context switches
     Thread *toBeDestroyed;	// finishing thread to be destroyed
     				// by the next thread that runs
+
+    void Charge(Thread *thread);// charge "thread" for the CPU time
+				// it has used since it was last charged
 };
 
 #endif // SCHEDULER_H
@@ -16,17 +16,14 @@
 // re-set the interrupt state back to its original value (whether
 // that be disabled or enabled).
 //
-// Once we'e implemented one set of higher level atomic operations,
-// we can implement others using that implementation.  We illustrate
-// this by implementing locks and condition variables on top of 
-// semaphores, instead of directly enabling and disabling interrupts.
+// All three keep their waiting threads on ThreadQueues, which are
+// linked through the threads themselves, so that waiting and waking
+// up never allocate memory.
 //
-// Locks are implemented using a semaphore to keep track of
-// whether the lock is held or not -- a semaphore value of 0 means
-// the lock is busy; a semaphore value of 1 means the lock is free.
-//
-// The implementation of condition variables using semaphores is
-// a bit trickier, as explained below under Condition::Wait.
+// Locks need to know which threads are waiting for them, to pass the
+// waiters' priority on to the thread holding the lock.  Condition
+// variables hand the threads they wake up straight to their lock, as
+// explained below under Condition::Signal.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -35,6 +32,114 @@
 #include "copyright.h"
 #include "synch.h"
 #include "main.h"
+#include "synchprofile.h"
+
+//----------------------------------------------------------------------
+// ProfileEntry
+// 	Return the contention counters for a synchronization object, or
+//	NULL if contention is not being profiled.  The counters are
+//	looked up the first time, and kept in "*entry" after that.
+//
+//	"kind" -- "semaphore", "lock" or "condition"
+//	"name" -- the object's debugging name
+//----------------------------------------------------------------------
+
+static SynchProfileEntry *
+ProfileEntry(SynchProfileEntry **entry, const char *kind, const char *name)
+{
+    if (kernel->synchProfiler == NULL) {
+	return NULL;
+    }
+    if (*entry == NULL) {
+	*entry = kernel->synchProfiler->Find(kind, name);
+    }
+    return *entry;
+}
+
+//----------------------------------------------------------------------
+// ThreadQueue::Append
+// 	Put a thread on the end of the queue.  It must not be on any 
+//	other queue.
+//----------------------------------------------------------------------
+
+void
+ThreadQueue::Append(Thread *thread)
+{
+    thread->nextWaiting = NULL;
+    if (first == NULL) {
+	first = thread;
+    } else {
+	last->nextWaiting = thread;
+    }
+    last = thread;
+}
+
+//----------------------------------------------------------------------
+// ThreadQueue::RemoveFront
+// 	Take the first thread off the queue, and return it.  The queue
+//	must not be empty.
+//----------------------------------------------------------------------
+
+Thread *
+ThreadQueue::RemoveFront()
+{
+    Thread *thread = first;
+
+    ASSERT(thread != NULL);
+    first = thread->nextWaiting;
+    if (first == NULL) {
+	last = NULL;
+    }
+    thread->nextWaiting = NULL;
+    return thread;
+}
+
+//----------------------------------------------------------------------
+// ThreadQueue::Remove
+// 	Take a thread off the queue, wherever it is.  It must be on the
+//	queue.
+//----------------------------------------------------------------------
+
+void
+ThreadQueue::Remove(Thread *thread)
+{
+    Thread *prev = NULL;
+
+    for (Thread *t = first; t != thread; t = t->nextWaiting) {
+	ASSERT(t != NULL);
+	prev = t;
+    }
+    if (prev == NULL) {
+	first = thread->nextWaiting;
+    } else {
+	prev->nextWaiting = thread->nextWaiting;
+    }
+    if (last == thread) {
+	last = prev;
+    }
+    thread->nextWaiting = NULL;
+}
+
+//----------------------------------------------------------------------
+// ThreadQueue::AppendAll
+// 	Move all the threads on "queue" onto the end of this one, in
+//	order, leaving "queue" empty.
+//----------------------------------------------------------------------
+
+void
+ThreadQueue::AppendAll(ThreadQueue *queue)
+{
+    if (queue->first == NULL) {
+	return;
+    }
+    if (first == NULL) {
+	first = queue->first;
+    } else {
+	last->nextWaiting = queue->first;
+    }
+    last = queue->last;
+    queue->first = queue->last = NULL;
+}
 
 //----------------------------------------------------------------------
 // Semaphore::Semaphore
@@ -48,7 +153,8 @@ Semaphore::Semaphore(const char* debugName, int initialValue)
 {
     name = debugName;
     value = initialValue;
-    queue = new List<Thread *>;
+    queue = new ThreadQueue;
+    profile = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -77,6 +183,9 @@ Semaphore::P()
 {
     Interrupt *interrupt = kernel->interrupt;
     Thread *currentThread = kernel->currentThread;
+    long long start = kernel->stats->totalTicks;
+    bool contended = (value == 0);
+    SynchProfileEntry *entry;
     
     // disable interrupts
     IntStatus oldLevel = interrupt->SetLevel(IntOff);	
@@ -86,6 +195,11 @@ Semaphore::P()
 	currentThread->Sleep(FALSE);
     } 
     value--; 			// semaphore available, consume its value
+
+    entry = ProfileEntry(&profile, "semaphore", name);
+    if (entry != NULL) {
+	entry->Acquired(contended, kernel->stats->totalTicks - start);
+    }
    
     // re-enable interrupts
     (void) interrupt->SetLevel(oldLevel);	
@@ -158,8 +272,10 @@ Semaphore::SelfTest()
 Lock::Lock(const char* debugName)
 {
     name = debugName;
-    semaphore = new Semaphore("lock", 1);  // initially, unlocked
-    lockHolder = NULL;
+    waiters = new ThreadQueue;
+    lockHolder = NULL;		// initially, unlocked
+    nextHeld = NULL;
+    profile = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -168,28 +284,54 @@ Lock::Lock(const char* debugName)
 //----------------------------------------------------------------------
 Lock::~Lock()
 {
-    delete semaphore;
+    delete waiters;
 }
 
 //----------------------------------------------------------------------
 // Lock::Acquire
 //	Atomically wait until the lock is free, then set it to busy.
-//	Equivalent to Semaphore::P(), with the semaphore value of 0
-//	equal to busy, and semaphore value of 1 equal to free.
+//	Like Semaphore::P(), except that while we wait, the thread
+//	holding the lock runs with (at least) our priority.
 //----------------------------------------------------------------------
 
 void Lock::Acquire()
 {
-    semaphore->P();
-    lockHolder = kernel->currentThread;
+    Interrupt *interrupt = kernel->interrupt;
+    Thread *currentThread = kernel->currentThread;
+    long long start = kernel->stats->totalTicks;
+    bool contended = (lockHolder != NULL);
+    SynchProfileEntry *entry;
+    
+    // disable interrupts
+    IntStatus oldLevel = interrupt->SetLevel(IntOff);	
+    
+    while (lockHolder != NULL) {	// lock busy, so go to sleep
+	waiters->Append(currentThread);
+	currentThread->waitingFor = this;
+	Donate(currentThread->getSchedulingPriority());
+	currentThread->Sleep(FALSE);
+    } 
+    currentThread->waitingFor = NULL;
+    lockHolder = currentThread;
+    nextHeld = currentThread->locksHeld;
+    currentThread->locksHeld = this;
+    acquiredAt = kernel->stats->totalTicks;
+
+    entry = ProfileEntry(&profile, "lock", name);
+    if (entry != NULL) {
+	entry->Acquired(contended, acquiredAt - start);
+    }
+   
+    // re-enable interrupts
+    (void) interrupt->SetLevel(oldLevel);	
 }
 
 //----------------------------------------------------------------------
 // Lock::Release
-//	Atomically set lock to be free, waking up a thread waiting
-//	for the lock, if any.
-//	Equivalent to Semaphore::V(), with the semaphore value of 0
-//	equal to busy, and semaphore value of 1 equal to free.
+//	Atomically set lock to be free, waking up the highest priority 
+//	thread waiting for the lock, if any.  Any priority we inherited
+//	through the lock is given back; if that leaves the woken thread
+//	with a higher priority than ours, let it run right away.
 //
 //	By convention, only the thread that acquired the lock
 // 	may release it.
@@ -197,9 +339,153 @@ void Lock::Acquire()
 
 void Lock::Release()
 {
+    Interrupt *interrupt = kernel->interrupt;
+    Thread *currentThread = kernel->currentThread;
+    Thread *waiter;
+
     ASSERT(IsHeldByCurrentThread());
+    
+    // disable interrupts
+    IntStatus oldLevel = interrupt->SetLevel(IntOff);	
+
+    waiter = Unlock();
+    if (waiter != NULL && waiter->getSchedulingPriority() >
+			currentThread->getSchedulingPriority()) {
+	currentThread->Yield();
+    }
+    
+    // re-enable interrupts
+    (void) interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// Lock::Unlock
+//	Set the lock to be free, and wake up the highest priority thread 
+//	waiting for it, if any.  Give back any priority the current 
+//	thread inherited through the lock.
+//
+//	Called with interrupts disabled.
+//
+// Returns:
+//	the thread woken up, or NULL if there were no waiters
+//---------------------------------------------------------------------
+
+Thread *Lock::Unlock()
+{
+    Thread *currentThread = kernel->currentThread;
+    Thread *waiter = NULL;
+    Lock **prev;
+    SynchProfileEntry *entry = ProfileEntry(&profile, "lock", name);
+
+    if (entry != NULL) {
+	entry->Released(kernel->stats->totalTicks - acquiredAt);
+    }
+
+    for (prev = &currentThread->locksHeld; *prev != this; 
+					prev = &(*prev)->nextHeld) {
+	ASSERT(*prev != NULL);
+    }
+    *prev = nextHeld;			// we no longer hold the lock
     lockHolder = NULL;
-    semaphore->V();
+
+    for (Thread *t = waiters->Front(); t != NULL; t = t->nextWaiting) {
+	if (waiter == NULL || t->getSchedulingPriority() >
+				waiter->getSchedulingPriority()) {
+	    waiter = t;
+	}
+    }
+    if (waiter != NULL) {		// make thread ready
+	waiters->Remove(waiter);
+	waiter->waitingFor = NULL;	// Acquire sets it again if the
+					// lock is taken before it runs
+	kernel->scheduler->ReadyToRun(waiter);
+    }
+    UpdateInheritance(currentThread);
+    return waiter;
+}
+
+//----------------------------------------------------------------------
+// Lock::Enqueue
+//	Move a queue of threads onto the list of threads waiting for
+//	the lock, as though each of them had called Acquire, and pass
+//	their priority on to the thread holding it.  Used by Condition
+//	to hand the threads it wakes up to its lock.
+//
+//	Called with interrupts disabled, and with the lock held.
+//---------------------------------------------------------------------
+
+void Lock::Enqueue(ThreadQueue *queue)
+{
+    int priority = -1;
+
+    for (Thread *t = queue->Front(); t != NULL; t = t->nextWaiting) {
+	t->waitingFor = this;
+	priority = max(priority, t->getSchedulingPriority());
+    }
+    waiters->AppendAll(queue);
+    Donate(priority);
+}
+
+//----------------------------------------------------------------------
+// Lock::Donate
+//	Called when a thread with "priority" starts waiting for the lock.
+//	Raise the priority of the thread holding it, and if that thread
+//	is itself waiting for a lock, of the holder of that lock, and
+//	so on down the chain.  Stop at the first thread whose priority
+//	is already high enough.
+//
+//	Called with interrupts disabled.
+//---------------------------------------------------------------------
+
+void Lock::Donate(int priority)
+{
+    Lock *lock = this;
+    Thread *holder;
+
+    while (lock != NULL && lock->lockHolder != NULL) {
+	holder = lock->lockHolder;
+	if (holder->getSchedulingPriority() >= priority) {
+	    break;
+	}
+	DEBUG(dbgSynch, "Lock " << lock->name << " raising " << holder->getName() << " to priority " << priority);
+	kernel->scheduler->SetInheritedPriority(holder, priority);
+	lock = holder->waitingFor;
+    }
+}
+
+//----------------------------------------------------------------------
+// Lock::HighestWaiter
+//	Return the highest scheduling priority of the threads waiting
+//	for the lock, or -1 if there are none.
+//---------------------------------------------------------------------
+
+int Lock::HighestWaiter()
+{
+    int priority = -1;
+
+    for (Thread *t = waiters->Front(); t != NULL; t = t->nextWaiting) {
+	priority = max(priority, t->getSchedulingPriority());
+    }
+    return priority;
+}
+
+//----------------------------------------------------------------------
+// Lock::UpdateInheritance
+//	Set the priority a thread inherits to the highest priority of
+//	the threads waiting for any lock it holds.
+//
+//	Called with interrupts disabled.
+//---------------------------------------------------------------------
+
+void Lock::UpdateInheritance(Thread *thread)
+{
+    int priority = -1;
+
+    for (Lock *lock = thread->locksHeld; lock != NULL; 
+					lock = lock->nextHeld) {
+	priority = max(priority, lock->HighestWaiter());
+    }
+    kernel->scheduler->SetInheritedPriority(thread, priority);
 }
 
 //----------------------------------------------------------------------
@@ -213,7 +499,8 @@ void Lock::Release()
 Condition::Condition(const char* debugName)
 {
     name = debugName;
-    waitQueue = new List<Semaphore *>;
+    waitQueue = new ThreadQueue;
+    profile = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -229,30 +516,45 @@ Condition::~Condition()
 //----------------------------------------------------------------------
 // Condition::Wait
 // 	Atomically release monitor lock and go to sleep.
-//	Our implementation uses semaphores to implement this, by
-//	allocating a semaphore for each waiting thread.  The signaller
-//	will V() this semaphore, so there is no chance the waiter
-//	will miss the signal, even though the lock is released before
-//	calling P().
+//	Putting ourselves on the wait queue, releasing the lock and
+//	going to sleep are all done with interrupts disabled, so there
+//	is no chance of missing a signal.
 //
 //	Note: we assume Mesa-style semantics, which means that the
 //	waiter must re-acquire the monitor lock when waking up.
+//	The signaller has already made us a waiter for the lock (see
+//	Signal), so when the lock is released we are made ready with
+//	the lock free, and take it in Acquire -- unless some other
+//	thread takes it first, in which case we wait for it again.
 //
 //	"conditionLock" -- lock protecting the use of this condition
 //----------------------------------------------------------------------
 
 void Condition::Wait(Lock* conditionLock) 
 {
-     Semaphore *waiter;
+    Interrupt *interrupt = kernel->interrupt;
+    Thread *currentThread = kernel->currentThread;
+    long long start = kernel->stats->totalTicks;
+    SynchProfileEntry *entry;
+    
+    ASSERT(conditionLock->IsHeldByCurrentThread());
+
+    // disable interrupts
+    IntStatus oldLevel = interrupt->SetLevel(IntOff);	
+
+    waitQueue->Append(currentThread);
+    (void) conditionLock->Unlock();
+    currentThread->Sleep(FALSE);	// until signalled
     
-     ASSERT(conditionLock->IsHeldByCurrentThread());
+    // re-enable interrupts
+    (void) interrupt->SetLevel(oldLevel);
+
+    conditionLock->Acquire();
 
-     waiter = new Semaphore("condition", 0);
-     waitQueue->Append(waiter);
-     conditionLock->Release();
-     waiter->P();
-     conditionLock->Acquire();
-     delete waiter;
+    entry = ProfileEntry(&profile, "condition", name);
+    if (entry != NULL) {
+	entry->Acquired(TRUE, kernel->stats->totalTicks - start);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -263,35 +565,313 @@ void Condition::Wait(Lock* conditionLock)
 //	signaller doesn't give up control immediately to the thread
 //	being woken up (unlike Hoare-style).
 //
+//	Since the signaller holds the monitor lock, the woken thread
+//	couldn't get far before blocking on the lock anyway.  So
+//	instead of making it ready, we move it straight onto the lock's
+//	wait queue; it runs once the lock is released.  This saves
+//	switching to it only for it to go back to sleep.
+//
 //	Also note: we assume the caller holds the monitor lock
 //	(unlike what is described in Birrell's paper).  This allows
-//	us to access waitQueue without disabling interrupts.
+//	us to access waitQueue without disabling interrupts.  (The 
+//	lock's wait queue still needs interrupts disabled.)
 //
 //	"conditionLock" -- lock protecting the use of this condition
 //----------------------------------------------------------------------
 
 void Condition::Signal(Lock* conditionLock)
 {
-    Semaphore *waiter;
+    ThreadQueue woken;
     
     ASSERT(conditionLock->IsHeldByCurrentThread());
     
     if (!waitQueue->IsEmpty()) {
-        waiter = waitQueue->RemoveFront();
-	waiter->V();
+	IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+
+	woken.Append(waitQueue->RemoveFront());
+	conditionLock->Enqueue(&woken);
+	(void) kernel->interrupt->SetLevel(oldLevel);
     }
 }
 
 //----------------------------------------------------------------------
 // Condition::Broadcast
-// 	Wake up all threads waiting on this condition, if any.
+// 	Wake up all threads waiting on this condition, if any.  As with
+//	Signal, they are moved onto the lock's wait queue -- all at
+//	once.
 //
 //	"conditionLock" -- lock protecting the use of this condition
 //----------------------------------------------------------------------
 
 void Condition::Broadcast(Lock* conditionLock) 
 {
-    while (!waitQueue->IsEmpty()) {
-        Signal(conditionLock);
+    ASSERT(conditionLock->IsHeldByCurrentThread());
+
+    if (!waitQueue->IsEmpty()) {
+	IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+
+	conditionLock->Enqueue(waitQueue);
+	(void) kernel->interrupt->SetLevel(oldLevel);
+    }
+}
+
+//----------------------------------------------------------------------
+// RWLock::RWLock
+// 	Initialize a reader-writer lock, so that it can be used for 
+//	synchronization.  Initially, unlocked.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//----------------------------------------------------------------------
+
+RWLock::RWLock(const char* debugName)
+{
+    name = debugName;
+    lock = new Lock("rwlock");
+    canRead = new Condition("rwlock read");
+    canWrite = new Condition("rwlock write");
+    numReaders = numWritersWaiting = 0;
+    writer = NULL;
+}
+
+//----------------------------------------------------------------------
+// RWLock::~RWLock
+// 	Deallocate a reader-writer lock.
+//----------------------------------------------------------------------
+
+RWLock::~RWLock()
+{
+    delete canWrite;
+    delete canRead;
+    delete lock;
+}
+
+//----------------------------------------------------------------------
+// RWLock::AcquireRead
+//	Wait until there is no writer holding or waiting for the lock,
+//	then hold it for reading.
+//----------------------------------------------------------------------
+
+void RWLock::AcquireRead()
+{
+    lock->Acquire();
+    while (writer != NULL || numWritersWaiting > 0) {
+	canRead->Wait(lock);
+    }
+    numReaders++;
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::ReleaseRead
+//	Stop reading.  The last reader out lets a writer in.
+//----------------------------------------------------------------------
+
+void RWLock::ReleaseRead()
+{
+    lock->Acquire();
+    ASSERT(numReaders > 0);
+    if (--numReaders == 0) {
+	canWrite->Signal(lock);
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::AcquireWrite
+//	Wait until no one holds the lock, then hold it for writing.
+//----------------------------------------------------------------------
+
+void RWLock::AcquireWrite()
+{
+    lock->Acquire();
+    numWritersWaiting++;
+    while (writer != NULL || numReaders > 0) {
+	canWrite->Wait(lock);
+    }
+    numWritersWaiting--;
+    writer = kernel->currentThread;
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::ReleaseWrite
+//	Stop writing.  Let the next writer in if there is one waiting,
+//	otherwise all the waiting readers.
+//
+//	By convention, only the thread that acquired the lock for 
+//	writing may release it.
+//----------------------------------------------------------------------
+
+void RWLock::ReleaseWrite()
+{
+    lock->Acquire();
+    ASSERT(writer == kernel->currentThread);
+    writer = NULL;
+    if (numWritersWaiting > 0) {
+	canWrite->Signal(lock);
+    } else {
+	canRead->Broadcast(lock);
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::SelfTest, RWLockReader, RWLockWriter
+// 	Test the reader-writer lock implementation.  While we hold the
+//	lock for reading, a second reader must be able to get in, and
+//	a writer must not.
+//----------------------------------------------------------------------
+
+static Semaphore *rwDone;		// signalled by each helper
+static int rwValue;			// only written by the writer
+
+static void
+RWLockReader (RWLock *rwlock) 
+{
+    rwlock->AcquireRead();
+    ASSERT(rwValue == 0);
+    rwlock->ReleaseRead();
+    rwDone->V();
+}
+
+static void
+RWLockWriter (RWLock *rwlock) 
+{
+    rwlock->AcquireWrite();
+    rwValue = 1;
+    rwlock->ReleaseWrite();
+    rwDone->V();
+}
+
+void
+RWLock::SelfTest()
+{
+    Thread *readerThread = new Thread("reader");
+    Thread *writerThread = new Thread("writer");
+
+    rwDone = new Semaphore("rwlock test", 0);
+    rwValue = 0;
+    AcquireRead();
+    readerThread->Fork((VoidFunctionPtr) RWLockReader, this);
+    rwDone->P();			// the reader got in alongside us
+    writerThread->Fork((VoidFunctionPtr) RWLockWriter, this);
+    kernel->currentThread->Yield();	// let the writer try to get in
+    ASSERT(rwValue == 0);
+    ReleaseRead();
+    rwDone->P();			// now the writer gets in
+    ASSERT(rwValue == 1);
+    delete rwDone;
+}
+
+//----------------------------------------------------------------------
+// Barrier::Barrier
+// 	Initialize a barrier, so that it can be used for synchronization.
+//	Initially, no threads have arrived.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//	"numThreads" is how many threads must call Wait() each round.
+//----------------------------------------------------------------------
+
+Barrier::Barrier(const char* debugName, int numThreads)
+{
+    ASSERT(numThreads > 0);
+    name = debugName;
+    lock = new Lock("barrier");
+    allArrived = new Condition("barrier");
+    this->numThreads = numThreads;
+    numArrived = 0;
+    round = 0;
+}
+
+//----------------------------------------------------------------------
+// Barrier::~Barrier
+// 	Deallocate a barrier.  Assume no one is still waiting at it!
+//----------------------------------------------------------------------
+
+Barrier::~Barrier()
+{
+    delete allArrived;
+    delete lock;
+}
+
+//----------------------------------------------------------------------
+// Barrier::Wait
+// 	Wait until all the threads have arrived at the barrier.  The
+//	last one to arrive starts a new round, and wakes the others.
+//	Waiters check the round, not the count, so that a thread
+//	racing ahead into the next round can't confuse them.
+//----------------------------------------------------------------------
+
+void Barrier::Wait()
+{
+    int myRound;
+
+    lock->Acquire();
+    myRound = round;
+    if (++numArrived == numThreads) {
+	numArrived = 0;
+	round++;
+	allArrived->Broadcast(lock);
+    } else {
+	while (round == myRound) {
+	    allArrived->Wait(lock);
+	}
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// Barrier::SelfTest, BarrierHelper
+// 	Test the barrier implementation, by having three threads go
+//	through it several times.  After each round, every thread must
+//	have finished the round.
+//----------------------------------------------------------------------
+
+const int BarrierTestThreads = 3;
+const int BarrierTestRounds = 5;
+
+static Semaphore *barrierDone;		// signalled by each helper
+static int barrierProgress[BarrierTestThreads];	
+					// rounds each thread has reached
+
+static void
+BarrierRounds (Barrier *barrier, int me) 
+{
+    for (int round = 1; round <= BarrierTestRounds; round++) {
+	barrierProgress[me] = round;
+	barrier->Wait();
+	for (int i = 0; i < BarrierTestThreads; i++) {
+	    ASSERT(barrierProgress[i] >= round);
+	}
+    }
+}
+
+static Barrier *barrierUnderTest;
+
+static void
+BarrierHelper (int me) 
+{
+    BarrierRounds(barrierUnderTest, me);
+    barrierDone->V();
+}
+
+void
+Barrier::SelfTest()
+{
+    ASSERT(numThreads == BarrierTestThreads);	// otherwise test won't work!
+    barrierDone = new Semaphore("barrier test", 0);
+    barrierUnderTest = this;
+    for (int i = 0; i < BarrierTestThreads; i++) {
+	barrierProgress[i] = 0;
+    }
+    for (int i = 1; i < BarrierTestThreads; i++) {
+	Thread *helper = new Thread("barrier helper");
+
+	helper->Fork((VoidFunctionPtr) BarrierHelper, (void *) i);
+    }
+    BarrierRounds(this, 0);
+    for (int i = 1; i < BarrierTestThreads; i++) {
+	barrierDone->P();
     }
+    delete barrierDone;
 }
@@ -19,6 +19,32 @@
 #include "list.h"
 #include "main.h"
 
+class SynchProfileEntry;
+
+// The following class defines a queue of threads waiting on a 
+// synchronization object.  The queue is linked through the threads 
+// themselves (Thread::nextWaiting), so putting a thread on it or
+// taking one off never allocates memory.  A thread can only be on
+// one queue at a time -- it is only ever waiting for one thing.
+
+class ThreadQueue {
+  public:
+    ThreadQueue() { first = last = NULL; }	// initially empty
+
+    bool IsEmpty() { return first == NULL; }
+    Thread *Front() { return first; }	// first thread, without removing
+					// it; follow nextWaiting for the rest
+    void Append(Thread *thread);	// put a thread on the end
+    Thread *RemoveFront();		// take the first thread off
+    void Remove(Thread *thread);	// take a thread off, out of turn
+    void AppendAll(ThreadQueue *queue);	// move all of "queue" onto the
+					// end, in constant time
+
+  private:
+    Thread *first;			// NULL if the queue is empty
+    Thread *last;
+};
+
 // The following class defines a "semaphore" whose value is a non-negative
 // integer.  The semaphore has only two operations P() and V():
 //
@@ -47,8 +73,9 @@ class Semaphore {
   private:
     const char* name;        // useful for debugging
     int value;         // semaphore value, always >= 0
-    List<Thread *> *queue;     
+    ThreadQueue *queue;     
 		  	// threads waiting in P() for the value to be > 0
+    SynchProfileEntry *profile;	// contention counters, if profiling
    };
 
 // The following class defines a "lock".  A lock can be BUSY or FREE.
@@ -62,6 +89,12 @@ class Semaphore {
 // In addition, by convention, only the thread that acquired the lock
 // may release it.  As with semaphores, you can't read the lock value
 // (because the value might change immediately after you read it).  
+//
+// Locks implement priority inheritance: while a thread waits for a 
+// lock, the thread holding it is scheduled at (at least) the waiter's
+// priority, and so on down the chain if the holder is itself waiting
+// for a lock.  This keeps threads of middling priority from holding
+// up a high priority thread indefinitely (priority inversion).
 
 class Lock {
   public:
@@ -82,7 +115,25 @@ class Lock {
   private:
     const char *name;			// debugging assist
     Thread *lockHolder;		// thread currently holding lock
-    Semaphore *semaphore;	// we use a semaphore to implement lock
+    ThreadQueue *waiters;	// threads waiting in Acquire()
+    Lock *nextHeld;		// next lock held by lockHolder
+    SynchProfileEntry *profile;	// contention counters, if profiling
+    long long acquiredAt;	// when lockHolder got the lock
+
+    Thread *Unlock();		// free the lock, and return the
+				// waiter woken up, if any
+    void Enqueue(ThreadQueue *queue);
+				// move "queue" onto "waiters"
+
+    void Donate(int priority);	// raise the priority of the holder,
+				// and of the threads it waits behind
+    int HighestWaiter();	// highest priority of the waiters
+    static void UpdateInheritance(Thread *thread);
+				// recompute the priority a thread
+				// inherits through its locks
+
+    friend class Condition;	// waits and signals move threads
+				// straight onto the lock
 };
 
 // The following class defines a "condition variable".  A condition
@@ -138,6 +189,67 @@ class Condition {
 
   private:
     const char* name;
-    List<Semaphore *> *waitQueue;	// list of waiting threads
+    ThreadQueue *waitQueue;		// list of waiting threads
+    SynchProfileEntry *profile;		// contention counters, if profiling
+};
+
+// The following class defines a "reader-writer lock".  Any number of
+// readers may hold the lock at once, or else a single writer.
+//
+//	AcquireRead -- wait until no writer holds the lock or is
+//		waiting for it, then hold it for reading
+//
+//	AcquireWrite -- wait until no one holds the lock, then hold
+//		it for writing
+//
+// Writers are preferred: once a writer is waiting, new readers wait
+// behind it, so that a steady stream of readers can't starve writers.
+// As with locks, only the thread that acquired the lock for writing
+// may release it.
+
+class RWLock {
+  public:
+    RWLock(const char* debugName);	// initialize lock to be FREE
+    ~RWLock();				// deallocate lock
+    const char* getName() { return name; }	// debugging assist
+
+    void AcquireRead();		// these are all *atomic*
+    void ReleaseRead();
+    void AcquireWrite();
+    void ReleaseWrite();
+    void SelfTest();		// test routine for RWLock implementation
+
+  private:
+    const char* name;		// debugging assist
+    Lock *lock;			// protects the fields below
+    Condition *canRead;		// readers wait here
+    Condition *canWrite;	// writers wait here
+    int numReaders;		// threads holding the lock for reading
+    int numWritersWaiting;	// threads waiting in AcquireWrite
+    Thread *writer;		// thread holding it for writing, if any
+};
+
+// The following class defines a "barrier" for a fixed number of
+// threads.  Each thread that calls Wait() waits there until all of
+// them have; then they all go on.  The barrier can be used again
+// right away, for the next round.
+
+class Barrier {
+  public:
+    Barrier(const char* debugName, int numThreads);
+				// initialize barrier for "numThreads"
+    ~Barrier();			// deallocate barrier
+    const char* getName() { return name; }	// debugging assist
+
+    void Wait();		// wait for the rest of the threads
+    void SelfTest();		// test routine for Barrier implementation
+
+  private:
+    const char* name;		// debugging assist
+    Lock *lock;			// protects the fields below
+    Condition *allArrived;	// threads wait here for the rest
+    int numThreads;		// threads that must arrive each round
+    int numArrived;		// threads that have so far this round
+    int round;			// rounds completed
 };
 #endif // SYNCH_H
@@ -0,0 +1,176 @@
+// synchprofile.cc
+//	Routines to count how synchronization objects are used, and to
+//	report which are the most contended.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "synchprofile.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// SynchProfileEntry::SynchProfileEntry
+// 	Initialize the counters for objects of one kind and name.
+//----------------------------------------------------------------------
+
+SynchProfileEntry::SynchProfileEntry(const char *kind, const char *name)
+{
+    this->kind = kind;
+    this->name = name;
+    acquires = contended = 0;
+    totalWait = maxWait = 0;
+    totalHold = maxHold = 0;
+}
+
+//----------------------------------------------------------------------
+// SynchProfileEntry::Acquired
+// 	Count a P, Acquire or Wait that has returned.
+//
+//	"contended" -- did the thread have to wait?
+//	"waitTicks" -- if so, for how long
+//----------------------------------------------------------------------
+
+void
+SynchProfileEntry::Acquired(bool contended, long long waitTicks)
+{
+    acquires++;
+    if (contended) {
+	this->contended++;
+	totalWait += waitTicks;
+	if (waitTicks > maxWait) {
+	    maxWait = waitTicks;
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// SynchProfileEntry::Released
+// 	Count the time a lock was held, once it is released.
+//----------------------------------------------------------------------
+
+void
+SynchProfileEntry::Released(long long holdTicks)
+{
+    totalHold += holdTicks;
+    if (holdTicks > maxHold) {
+	maxHold = holdTicks;
+    }
+}
+
+//----------------------------------------------------------------------
+// SynchProfileEntry::Print
+// 	Print one line of the contention report.
+//----------------------------------------------------------------------
+
+void
+SynchProfileEntry::Print()
+{
+    cout << kind << " \"" << name << "\": " << acquires << " acquires, "
+	 << contended << " contended, wait " << totalWait << " total/"
+	 << maxWait << " max";
+    if (totalHold > 0) {
+	cout << ", held " << totalHold << " total/" << maxHold << " max";
+    }
+    cout << "\n";
+}
+
+//----------------------------------------------------------------------
+// SynchProfiler::SynchProfiler
+// 	Initialize the profiler, with no objects profiled yet.
+//----------------------------------------------------------------------
+
+SynchProfiler::SynchProfiler()
+{
+    entries = new List<SynchProfileEntry *>;
+}
+
+//----------------------------------------------------------------------
+// SynchProfiler::~SynchProfiler
+// 	De-allocate the profiler, and all its counters.
+//----------------------------------------------------------------------
+
+SynchProfiler::~SynchProfiler()
+{
+    while (!entries->IsEmpty()) {
+	delete entries->RemoveFront();
+    }
+    delete entries;
+}
+
+//----------------------------------------------------------------------
+// SynchProfiler::Find
+// 	Return the counters for objects of a kind and name.  Objects
+//	look up their counters once, and keep a pointer to them, so
+//	a linear search is fast enough.
+//
+//	"kind" -- "semaphore", "lock" or "condition"
+//	"name" -- the object's debugging name
+//----------------------------------------------------------------------
+
+SynchProfileEntry *
+SynchProfiler::Find(const char *kind, const char *name)
+{
+    SynchProfileEntry *entry;
+
+    ListIterator<SynchProfileEntry *> iter(entries);
+    for (; !iter.IsDone(); iter.Next()) {
+	entry = iter.Item();
+	if (strcmp(entry->kind, kind) == 0 && strcmp(entry->name, name) == 0) {
+	    return entry;
+	}
+    }
+    entry = new SynchProfileEntry(kind, name);
+    entries->Append(entry);
+    return entry;
+}
+
+//----------------------------------------------------------------------
+// WaitCompare
+// 	Order profile entries by total wait time, longest first, for
+//	the report.  Totals can be too large to subtract and return
+//	as an int, so compare them instead.
+//----------------------------------------------------------------------
+
+static int
+WaitCompare(SynchProfileEntry *x, SynchProfileEntry *y)
+{
+    if (x->totalWait > y->totalWait) {
+	return -1;
+    } else if (x->totalWait < y->totalWait) {
+	return 1;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// PrintEntry
+// 	Print one entry.  Dummy function because C++ does not (easily)
+//	allow pointers to member functions.
+//----------------------------------------------------------------------
+
+static void
+PrintEntry(SynchProfileEntry *entry)
+{
+    entry->Print();
+}
+
+//----------------------------------------------------------------------
+// SynchProfiler::Print
+// 	Print the contention report: the counters for each kind and
+//	name of object, the ones threads waited on longest first.
+//----------------------------------------------------------------------
+
+void
+SynchProfiler::Print()
+{
+    SortedList<SynchProfileEntry *> ranked(WaitCompare);
+
+    ListIterator<SynchProfileEntry *> iter(entries);
+    for (; !iter.IsDone(); iter.Next()) {
+	ranked.Insert(iter.Item());
+    }
+    cout << "Synchronization contention, by total wait (ticks):\n";
+    ranked.Apply(PrintEntry);
+}
@@ -0,0 +1,66 @@
+// synchprofile.h
+//	Data structures for profiling contention on synchronization
+//	objects -- how often semaphores, locks and condition variables
+//	are used, how often and how long threads wait on them, and
+//	how long locks are held.
+//
+//	Objects are profiled by kind and name, so all the objects
+//	created with the same name (for instance, the locks of every
+//	pipe) are counted together.  Times are in simulated ticks.
+//
+//	Profiling is off unless Nachos is started with "-cs"; the report
+//	is printed when Nachos halts.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SYNCHPROFILE_H
+#define SYNCHPROFILE_H
+
+#include "copyright.h"
+#include "list.h"
+
+// The following class defines the counters kept for synchronization
+// objects of one kind and name.
+
+class SynchProfileEntry {
+  public:
+    SynchProfileEntry(const char *kind, const char *name);
+
+    void Acquired(bool contended, long long waitTicks);
+				// P, Acquire or Wait has returned, after
+				// waiting "waitTicks" if "contended"
+    void Released(long long holdTicks);
+				// a lock was held for "holdTicks"
+    void Print();
+
+    const char *kind;		// "semaphore", "lock" or "condition"
+    const char *name;		// debugging name of the objects
+    int acquires;		// number of P, Acquire or Wait calls
+    int contended;		// how many of them had to wait
+    long long totalWait;	// ticks spent waiting
+    long long maxWait;		// longest single wait
+    long long totalHold;	// ticks locks were held
+    long long maxHold;		// longest single hold
+};
+
+// The following class keeps track of the profiled objects.
+
+class SynchProfiler {
+  public:
+    SynchProfiler();		// nothing profiled yet
+    ~SynchProfiler();
+
+    SynchProfileEntry *Find(const char *kind, const char *name);
+				// Return the counters for objects of
+				// this kind and name, creating them the
+				// first time
+    void Print();		// Print the counters, most total wait
+				// time first
+
+  private:
+    List<SynchProfileEntry *> *entries;
+};
+
+#endif // SYNCHPROFILE_H
@@ -25,6 +25,14 @@
 // this is put at the top of the execution stack, for detecting stack overflows
 const int STACK_FENCEPOST = 0xdedbeef;
 
+// Execution stacks of threads that have been deleted, kept for the
+// next threads to be forked.  Each stack on the list holds a pointer to
+// the next one in its first word, so the list needs no memory of its
+// own; the guard pages around each stack stay in place.
+static int *freeStacks = NULL;
+
+int Thread::stackSize = StackSize;
+
 //----------------------------------------------------------------------
 // Thread::Thread
 // 	Initialize a thread control block, so that we can then call
@@ -41,7 +49,6 @@ Thread::Thread(char* threadName)
 				ASSERT(threadsNum <= MaxThreadsNum);
 	}
 	DEBUG(dbgSys, "Thread Name: " << threadName << " created\n");
-	cout << "Thread Name: " << threadName << " created"  << endl;
 	priority= 0;
     name = threadName;
     stackTop = NULL;
@@ -53,6 +60,13 @@ Thread::Thread(char* threadName)
 															// of machine registers
     }
     space = NULL;
+    effectivePriority = priority;
+    sliceTicks = sliceStart = 0;
+    boostEpoch = -1;
+    pass = 0;
+    inheritedPriority = -1;
+    waitingFor = locksHeld = NULL;
+    nextWaiting = NULL;
 }
 
 Thread::Thread(char* threadName, int pri)
@@ -64,8 +78,8 @@ Thread::Thread(char* threadName, int pri)
 	}
 
 	if (pri < 0) 	pri = 0;
+	if (pri >= NumPriorities) 	pri = NumPriorities - 1;
 	DEBUG(dbgSys, "Thread Name: " << threadName << " created, Priority: " << pri << "\n");
-	cout << "Thread Name: " << threadName << " created, Priority: " << pri << endl;
 	priority = pri;
     name = threadName;
     stackTop = NULL;
@@ -77,6 +91,13 @@ Thread::Thread(char* threadName, int pri)
 															// of machine registers
     }
     space = NULL;
+    effectivePriority = priority;
+    sliceTicks = sliceStart = 0;
+    boostEpoch = -1;
+    pass = 0;
+    inheritedPriority = -1;
+    waitingFor = locksHeld = NULL;
+    nextWaiting = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -89,6 +110,9 @@ Thread::Thread(char* threadName, int pri)
 //      NOTE: if this is the main thread, we can't delete the stack
 //      because we didn't allocate it -- we got it automatically
 //      as part of starting up Nachos.
+//
+//	Other threads' stacks are not freed, but kept for reuse by the
+//	next thread to be forked.
 //----------------------------------------------------------------------
 
 Thread::~Thread()
@@ -96,8 +120,10 @@ Thread::~Thread()
     DEBUG(dbgThread, "Deleting thread: " << name);
 
     ASSERT(this != kernel->currentThread);
-    if (stack != NULL)
-    	DeallocBoundedArray((char *) stack, StackSize * sizeof(int));
+    if (stack != NULL) {		// keep the stack for the next thread
+	*(int **) stack = freeStacks;
+	freeStacks = stack;
+    }
 
     threadsNum--;
 }
@@ -159,7 +185,7 @@ Thread::CheckOverflow()
 {
     if (stack != NULL) {
 #ifdef HPUX			// Stacks grow upward on the Snakes
-	ASSERT(stack[StackSize - 1] == STACK_FENCEPOST);
+	ASSERT(stack[stackSize - 1] == STACK_FENCEPOST);
 #else
 	ASSERT(*stack == STACK_FENCEPOST);
 #endif
@@ -328,6 +354,40 @@ PLabelToAddr(void *plabel)
 }
 #endif
 
+//----------------------------------------------------------------------
+// Thread::SetStackSize
+//	Change the size of the execution stacks of threads forked from
+//	now on.  Stacks kept for reuse are the old size, so they are
+//	given back.
+//
+//	"words" is the new stack size, in words
+//----------------------------------------------------------------------
+
+void
+Thread::SetStackSize (int words)
+{
+    ASSERT(words > 0);
+    FreeStacks();
+    stackSize = words;
+}
+
+//----------------------------------------------------------------------
+// Thread::FreeStacks
+//	Give back the execution stacks kept for reuse.  Stacks of
+//	threads that have not been deleted are not affected.
+//----------------------------------------------------------------------
+
+void
+Thread::FreeStacks ()
+{
+    while (freeStacks != NULL) {
+	int *next = *(int **) freeStacks;
+
+	DeallocBoundedArray((char *) freeStacks, stackSize * sizeof(int));
+	freeStacks = next;
+    }
+}
+
 //----------------------------------------------------------------------
 // Thread::StackAllocate
 //	Allocate and initialize an execution stack.  The stack is
@@ -343,34 +403,39 @@ PLabelToAddr(void *plabel)
 void
 Thread::StackAllocate (VoidFunctionPtr func, void *arg)
 {
-    stack = (int *) AllocBoundedArray(StackSize * sizeof(int));
+    if (freeStacks != NULL) {		// reuse a stack if there is one
+	stack = freeStacks;
+	freeStacks = *(int **) stack;
+    } else {
+	stack = (int *) AllocBoundedArray(stackSize * sizeof(int));
+    }
 
 #ifdef PARISC
     // HP stack works from low addresses to high addresses
     // everyone else works the other way: from high addresses to low addresses
     stackTop = stack + 16;	// HP requires 64-byte frame marker
-    stack[StackSize - 1] = STACK_FENCEPOST;
+    stack[stackSize - 1] = STACK_FENCEPOST;
 #endif
 
 #ifdef SPARC
-    stackTop = stack + StackSize - 96; 	// SPARC stack must contains at 
+    stackTop = stack + stackSize - 96; 	// SPARC stack must contains at 
 					// least 1 activation record 
 					// to start with.
     *stack = STACK_FENCEPOST;
 #endif 
 
 #ifdef PowerPC // RS6000
-    stackTop = stack + StackSize - 16; 	// RS6000 requires 64-byte frame marker
+    stackTop = stack + stackSize - 16; 	// RS6000 requires 64-byte frame marker
     *stack = STACK_FENCEPOST;
 #endif 
 
 #ifdef DECMIPS
-    stackTop = stack + StackSize - 4;	// -4 to be on the safe side!
+    stackTop = stack + stackSize - 4;	// -4 to be on the safe side!
     *stack = STACK_FENCEPOST;
 #endif
 
 #ifdef ALPHA
-    stackTop = stack + StackSize - 8;	// -8 to be on the safe side!
+    stackTop = stack + stackSize - 8;	// -8 to be on the safe side!
     *stack = STACK_FENCEPOST;
 #endif
 
@@ -379,7 +444,7 @@ Thread::StackAllocate (VoidFunctionPtr func, void *arg)
     // the x86 passes the return address on the stack.  In order for SWITCH() 
     // to go to ThreadRoot when we switch to this thread, the return addres 
     // used in SWITCH() must be the starting address of ThreadRoot.
-    stackTop = stack + StackSize - 4;	// -4 to be on the safe side!
+    stackTop = stack + stackSize - 4;	// -4 to be on the safe side!
     *(--stackTop) = (int) ThreadRoot;
     *stack = STACK_FENCEPOST;
 #endif
@@ -24,7 +24,7 @@
 //	that your thread stacks are too small.)
 //	
 //	One thing to try if you find yourself with seg faults is to
-//	increase the size of thread stack -- ThreadStackSize.
+//	increase the size of thread stack -- StackSize, or "-ss" at boot.
 //
 //  	In this interface, forking a thread takes two steps.
 //	We must first allocate a data structure for it: "t = new Thread".
@@ -44,6 +44,8 @@
 #include "machine.h"
 #include "addrspace.h"
 
+class Lock;
+
 #define MaxThreadsNum 128
 // CPU register state to be saved on context switch.  
 // The x86 needs to save only a few registers, 
@@ -55,10 +57,14 @@
 #define MachineStateSize 75 
 
 
-// Size of the thread's private execution stack.
+// Default size of the thread's private execution stack.
 // WATCH OUT IF THIS ISN'T BIG ENOUGH!!!!!
 const int StackSize = (8 * 1024);	// in words
 
+// Thread priorities run from 0 (the default, and lowest) up to
+// NumPriorities - 1; the scheduler keeps one ready queue per level.
+const int NumPriorities = 32;
+
 
 // Thread state
 enum ThreadStatus { JUST_CREATED, RUNNING, READY, BLOCKED };
@@ -82,6 +88,9 @@ class Thread {
     int *stackTop;			 // the current stack pointer
     void *machineState[MachineStateSize];  // all registers except for stackTop
     int priority;  // Priority of the thread
+    int effectivePriority;  // Priority the scheduler queues it at
+    int inheritedPriority;  // Highest priority of the threads waiting
+			    // for its locks, or -1
 
   public:
     Thread(char* debugName);		// initialize a Thread
@@ -93,6 +102,14 @@ class Thread {
 
     // basic thread operations
     int getPriority();
+    int getEffectivePriority() { return effectivePriority; }
+    void setEffectivePriority(int pri) { effectivePriority = pri; }
+    void setInheritedPriority(int pri) { inheritedPriority = pri; }
+    int getSchedulingPriority() { return max(effectivePriority, 
+					     inheritedPriority); }
+				// the priority it is scheduled at,
+				// including any inherited from threads
+				// waiting for its locks
     void Fork(VoidFunctionPtr func, void *arg); 
     				// Make thread run (*func)(arg)
     void Yield();  		// Relinquish the CPU if any 
@@ -104,6 +121,7 @@ class Thread {
     
     void CheckOverflow();   	// Check if thread stack has overflowed
     void setStatus(ThreadStatus st) { status = st; }
+    ThreadStatus getStatus() { return status; }
     char* getName() { return (name); }
     void Print() { cout << name; }
     void SelfTest();		// test whether thread impl is working
@@ -120,6 +138,7 @@ class Thread {
     void StackAllocate(VoidFunctionPtr func, void *arg);
     				// Allocate a stack for thread.
 				// Used internally by Fork()
+    static int stackSize;	// words in each thread's stack
 
 // A thread running a user program actually has *two* sets of CPU registers -- 
 // one for its state while executing user code, one for its state 
@@ -129,10 +148,31 @@ class Thread {
 
   public:
     static int threadsNum;
+    static void SetStackSize(int words);
+					// size of stacks forked from now on
+    static void FreeStacks();		// free stacks kept for reuse
     void SaveUserState();		// save user-level register state
     void RestoreUserState();		// restore user-level register state
 
     AddrSpace *space;			// User code this thread is running.
+
+// Bookkeeping for the scheduler's time-slice accounting.
+
+    long long sliceStart;		// when it was last charged for the
+					// CPU time it has used
+    int sliceTicks;			// CPU time counted against its
+					// feedback quantum
+    int boostEpoch;			// last feedback boost it has seen
+    unsigned int pass;			// stride scheduling virtual time
+
+// Bookkeeping for priority inheritance by Locks.
+
+    Lock *waitingFor;			// lock it is waiting to acquire
+    Lock *locksHeld;			// locks it holds, linked through
+					// Lock::nextHeld
+
+    Thread *nextWaiting;		// next thread on the ThreadQueue
+					// it is waiting on
 };
 
 // external function, dummy routine whose sole job is to call Thread::Print
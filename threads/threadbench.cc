@@ -0,0 +1,187 @@
+// threadbench.cc
+//	Benchmarks for the threading core, run with "nachos -bench threads".
+//	Each benchmark times a loop of some operation in host time, and
+//	reports how long one operation took and how many were done per
+//	second.  The numbers include the cost of simulating the timer
+//	interrupts that go off along the way, as real workloads do.
+//
+//	The benchmarks are:
+//		semaphore ping-pong -- two threads take turns, handing
+//			the CPU back and forth with a pair of Semaphores
+//		fork/finish -- fork a thread that does nothing, and
+//			let it run to completion
+//		yield storm -- many threads all calling Yield
+//		lock/condition handoff -- a producer and a consumer
+//			passing items through a one-slot buffer
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "threadbench.h"
+#include "main.h"
+#include "synch.h"
+#include "sysdep.h"
+
+const int BenchIterations = 100000;	// operations timed per benchmark
+const int NumStormThreads = 32;		// threads in the yield storm
+
+static Semaphore *ping, *pong;		// for the ping-pong benchmark
+static Semaphore *benchDone;		// signalled by finished workers
+
+static Lock *slotLock;			// for the handoff benchmark
+static Condition *slotFull, *slotEmpty;
+static bool slotInUse;
+
+//----------------------------------------------------------------------
+// Report
+//	Print the results of one benchmark.
+//
+//	"name" -- what was timed
+//	"ops" -- how many operations were done
+//	"seconds" -- host time they took
+//----------------------------------------------------------------------
+
+static void
+Report(const char *name, int ops, double seconds)
+{
+    cout << name << ": " << ops << " ops in " << seconds << " s, "
+	 << (seconds * 1e9 / ops) << " ns/op, "
+	 << (int) (ops / seconds) << " ops/sec\n";
+}
+
+//----------------------------------------------------------------------
+// PingPong
+//	The other half of the ping-pong benchmark: wait to be pinged,
+//	then pong back.
+//----------------------------------------------------------------------
+
+static void
+PingPong(void *)
+{
+    for (int i = 0; i < BenchIterations; i++) {
+	ping->P();
+	pong->V();
+    }
+}
+
+//----------------------------------------------------------------------
+// Nothing
+//	The thread forked by the fork/finish benchmark.
+//----------------------------------------------------------------------
+
+static void
+Nothing(void *)
+{
+}
+
+//----------------------------------------------------------------------
+// YieldLoop
+//	One of the threads in the yield storm.
+//
+//	"arg" -- how many times to yield
+//----------------------------------------------------------------------
+
+static void
+YieldLoop(void *arg)
+{
+    int count = *(int *) arg;
+
+    for (int i = 0; i < count; i++) {
+	kernel->currentThread->Yield();
+    }
+    benchDone->V();
+}
+
+//----------------------------------------------------------------------
+// Consumer
+//	The consumer in the handoff benchmark: empty the slot each time
+//	the producer fills it.
+//----------------------------------------------------------------------
+
+static void
+Consumer(void *)
+{
+    for (int i = 0; i < BenchIterations; i++) {
+	slotLock->Acquire();
+	while (!slotInUse) {
+	    slotFull->Wait(slotLock);
+	}
+	slotInUse = FALSE;
+	slotEmpty->Signal(slotLock);
+	slotLock->Release();
+    }
+    benchDone->V();
+}
+
+//----------------------------------------------------------------------
+// ThreadBenchmark
+//	Run each of the benchmarks in turn, from the main thread.
+//----------------------------------------------------------------------
+
+void
+ThreadBenchmark()
+{
+    double start;
+    int yieldsEach = BenchIterations / NumStormThreads;
+    Thread *t;
+
+    benchDone = new Semaphore("bench done", 0);
+
+    ping = new Semaphore("ping", 0);
+    pong = new Semaphore("pong", 0);
+    t = new Thread("ping-pong");
+    t->Fork(PingPong, NULL);
+    start = HostTime();
+    for (int i = 0; i < BenchIterations; i++) {
+	ping->V();
+	pong->P();
+    }
+    Report("semaphore ping-pong (switches)", 2 * BenchIterations,
+	   HostTime() - start);
+    delete ping;
+    delete pong;
+
+    start = HostTime();
+    for (int i = 0; i < BenchIterations; i++) {
+	t = new Thread("nothing");
+	t->Fork(Nothing, NULL);
+	kernel->currentThread->Yield();	// let it run and finish
+    }
+    Report("fork/finish", BenchIterations, HostTime() - start);
+
+    for (int i = 0; i < NumStormThreads; i++) {
+	t = new Thread("yielder");
+	t->Fork(YieldLoop, &yieldsEach);
+    }
+    start = HostTime();
+    for (int i = 0; i < NumStormThreads; i++) {
+	benchDone->P();
+    }
+    Report("yield storm", NumStormThreads * yieldsEach, HostTime() - start);
+
+    slotLock = new Lock("slot lock");
+    slotFull = new Condition("slot full");
+    slotEmpty = new Condition("slot empty");
+    slotInUse = FALSE;
+    t = new Thread("consumer");
+    t->Fork(Consumer, NULL);
+    start = HostTime();
+    for (int i = 0; i < BenchIterations; i++) {
+	slotLock->Acquire();
+	while (slotInUse) {
+	    slotEmpty->Wait(slotLock);
+	}
+	slotInUse = TRUE;
+	slotFull->Signal(slotLock);
+	slotLock->Release();
+    }
+    benchDone->P();
+    Report("lock/condition handoff", BenchIterations, HostTime() - start);
+    delete slotEmpty;
+    delete slotFull;
+    delete slotLock;
+
+    delete benchDone;
+}
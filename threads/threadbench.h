@@ -0,0 +1,16 @@
+// threadbench.h
+//	Defines benchmarks for the threading core -- context switches,
+//	thread creation, and synchronization handoffs.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef THREADBENCH_H
+#define THREADBENCH_H
+
+#include "copyright.h"
+
+extern void ThreadBenchmark();
+
+#endif // THREADBENCH_H
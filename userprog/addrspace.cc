@@ -3,6 +3,7 @@
 #include "addrspace.h"
 #include "machine.h"
 #include "noff.h"
+#include "syscall.h"
 #include "synch.h"
 
 static void SwapHeader(NoffHeader *noffH) {
@@ -58,6 +59,10 @@ AddrSpace::AddrSpace() {
 		pageTable[i].dirty = FALSE;
 		pageTable[i].readOnly = FALSE;
 	}
+	for (int i = 0; i < MaxShmSegments; ++i) {
+		shmAttachedAt[i] = -1;
+		shmHeld[i] = FALSE;
+	}
 }
 
 //----------------------------------------------------------------------
@@ -66,6 +71,14 @@ AddrSpace::AddrSpace() {
 //----------------------------------------------------------------------
 
 AddrSpace::~AddrSpace() {
+	for (int i = 0; i < MaxShmSegments; ++i) {
+		if (shmAttachedAt[i] >= 0) {
+			ShmDetach(i);
+		}
+		if (shmHeld[i]) {
+			ShmRelease(i);
+		}
+	}
 	delete pageTable;
 }
 
@@ -293,10 +306,40 @@ ExceptionType AddrSpace::Translate(unsigned int vaddr, unsigned int *paddr,
 	return NoException;
 }
 
+//----------------------------------------------------------------------
+// AddrSpace::IsMapped
+//	Return whether virtual address "vaddr" is backed by memory: either
+//	its page is in a frame, or it has been swapped out and a page
+//	fault will bring it back.  Pages that were never loaded (and
+//	unmapped shared memory) have no frame at all.
+//----------------------------------------------------------------------
+
+bool AddrSpace::IsMapped(unsigned int vaddr) {
+	unsigned int vpn = vaddr / PageSize;
+
+	if (vpn >= numPages) {
+		return FALSE;
+	}
+	return pageTable[vpn].valid || pageTable[vpn].physicalPage >= 0;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::IsResident
+//	Return whether virtual address "vaddr" is in a frame now, so
+//	reading it won't page fault.
+//----------------------------------------------------------------------
+
+bool AddrSpace::IsResident(unsigned int vaddr) {
+	unsigned int vpn = vaddr / PageSize;
+
+	return vpn < numPages && pageTable[vpn].valid;
+}
+
 //----------------------------------------------------------
 #include <list>
 using std::list;
 static int referCount[NumPhysPages]; //记录每一个swapArray对应的索引的链表的长度，即对应的物理页框的数
+static bool sharedFrame[NumPhysPages]; // 共享内存段使用的页框，不参与置换
 list<SwapId*> swapArray[NumPhysPages];
 // 页被置换出来之后，将其保存到一个地方，即一个swapArray数组中，元素的个数等于物理页框的数量，数组中保存的是一个链表，每换出一页，对应的链表
 // 中增加一项，每换出一页，则在对应的链表中减去此项。
@@ -305,11 +348,13 @@ int AddrSpace::NextPageToSwapInplace() {
 	int pageNum = -1;
 	for (int i = 0; i < numPages; i++) {
 		if (pageNum == -1) {
-			if (pageTable[i].valid && !pageTable[i].readOnly) {
+			if (pageTable[i].valid && !pageTable[i].readOnly
+					&& !sharedFrame[pageTable[i].physicalPage]) {
 				pageNum = i;
 			}
 		} else {
-			if (pageTable[i].valid && !pageTable[i].readOnly) {
+			if (pageTable[i].valid && !pageTable[i].readOnly
+					&& !sharedFrame[pageTable[i].physicalPage]) {
 				if ((referCount[pageTable[i].physicalPage])
 						< referCount[pageTable[pageNum].physicalPage]) {
 					pageNum = i;
@@ -386,3 +431,198 @@ void AddrSpace::HandleSwap(int virtualPageNum)
 		}
 	}
 }
+
+//----------------------------------------------------------------------
+// Shared memory segments
+//	A segment is a run of physical frames that any number of address
+//	spaces can map, each at a virtual address of its own choosing.
+//	referCount counts one reference for the segment itself, plus one
+//	per address space it is attached to.
+//
+//	A segment is held by every address space that created or attached
+//	it, until that address space goes away -- detaching only unmaps
+//	it.  So a producer can create a segment, fill it in and detach
+//	before the consumer attaches, and the data is still there; and the
+//	segment and its frames are freed when the last program holding it
+//	exits, even if it was never attached.
+//----------------------------------------------------------------------
+
+struct ShmSegment {
+	bool inUse;
+	int key;
+	int numPages;
+	int numHolders;		// address spaces holding the segment
+	int frames[MaxShmPages];
+};
+
+static ShmSegment shmSegments[MaxShmSegments];
+
+//----------------------------------------------------------------------
+// AddrSpace::ShmCreate
+//	Find the shared segment named "key", or create one of "size"
+//	bytes.  The new segment's frames are zero-filled.  Either way,
+//	this address space holds the segment until it goes away.
+//
+//	Returns the segment id, or a negative error code.
+//----------------------------------------------------------------------
+
+int AddrSpace::ShmCreate(int key, int size) {
+	int numPages = divRoundUp(size, PageSize);
+	int id = -1;
+
+	if (size <= 0 || numPages > MaxShmPages) {
+		return EINVAL;
+	}
+	for (int i = 0; i < MaxShmSegments; ++i) {
+		if (shmSegments[i].inUse && shmSegments[i].key == key) {
+			if (shmSegments[i].numPages < numPages) {
+				return EINVAL;
+			}
+			ShmHold(i);			// already exists
+			return i;
+		}
+		if (!shmSegments[i].inUse && id < 0) {
+			id = i;
+		}
+	}
+	if (id < 0) {
+		return ENOSPC;
+	}
+
+	// 共享页框只能使用空闲页框，不能把别人的页换出
+	int numFree = 0;
+	for (int f = 0; f < NumPhysPages; ++f) {
+		if (referCount[f] == 0) {
+			numFree++;
+		}
+	}
+	if (numFree < numPages) {
+		return ENOMEM;
+	}
+
+	ShmSegment *seg = &shmSegments[id];
+	seg->inUse = TRUE;
+	seg->key = key;
+	seg->numPages = numPages;
+	seg->numHolders = 0;
+	for (int i = 0, f = 0; i < numPages; ++f) {
+		if (referCount[f] == 0) {
+			referCount[f] = 1;		// the segment's own reference
+			sharedFrame[f] = TRUE;
+			bzero(&(kernel->machine->mainMemory[f * PageSize]), PageSize);
+			seg->frames[i++] = f;
+		}
+	}
+	DEBUG(dbgAddr, "Created shared segment " << id << ", key " << key
+			<< ", " << numPages << " pages");
+	ShmHold(id);
+	return id;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::ShmAttach
+//	Map shared segment "shmId" into this address space, starting at
+//	"vaddr" (which must be page aligned, and not already in use).
+//
+//	Returns 0, or a negative error code.
+//----------------------------------------------------------------------
+
+int AddrSpace::ShmAttach(int shmId, unsigned int vaddr) {
+	if (shmId < 0 || shmId >= MaxShmSegments || !shmSegments[shmId].inUse) {
+		return EINVAL;
+	}
+	if (shmAttachedAt[shmId] >= 0) {
+		return EEXIST;
+	}
+	ShmSegment *seg = &shmSegments[shmId];
+	unsigned int vpn = vaddr / PageSize;
+	if (vaddr % PageSize != 0 || vpn + seg->numPages > numPages) {
+		return EINVAL;
+	}
+	for (int i = 0; i < seg->numPages; ++i) {
+		if (IsMapped((vpn + i) * PageSize)) {
+			return EINVAL;			// in use, maybe swapped out
+		}
+	}
+	for (int i = 0; i < seg->numPages; ++i) {
+		pageTable[vpn + i].physicalPage = seg->frames[i];
+		pageTable[vpn + i].valid = TRUE;
+		pageTable[vpn + i].readOnly = FALSE;
+		pageTable[vpn + i].use = FALSE;
+		pageTable[vpn + i].dirty = FALSE;
+		++referCount[seg->frames[i]];
+	}
+	ShmHold(shmId);
+	shmAttachedAt[shmId] = vpn;
+	DEBUG(dbgAddr, "Attached shared segment " << shmId << " at " << vaddr);
+	return 0;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::ShmDetach
+//	Unmap shared segment "shmId" from this address space.  The
+//	segment itself stays until every address space holding it has
+//	gone away (see AddrSpace::ShmRelease).
+//
+//	Returns 0, or a negative error code.
+//----------------------------------------------------------------------
+
+int AddrSpace::ShmDetach(int shmId) {
+	if (shmId < 0 || shmId >= MaxShmSegments || shmAttachedAt[shmId] < 0) {
+		return EINVAL;
+	}
+	ShmSegment *seg = &shmSegments[shmId];
+	unsigned int vpn = shmAttachedAt[shmId];
+	for (int i = 0; i < seg->numPages; ++i) {
+		pageTable[vpn + i].physicalPage = -1;
+		pageTable[vpn + i].valid = FALSE;
+		--referCount[seg->frames[i]];
+	}
+	shmAttachedAt[shmId] = -1;
+	DEBUG(dbgAddr, "Detached shared segment " << shmId);
+	return 0;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::ShmHold
+//	Count this address space as holding shared segment "shmId", if
+//	it doesn't already.
+//----------------------------------------------------------------------
+
+void AddrSpace::ShmHold(int shmId) {
+	if (!shmHeld[shmId]) {
+		shmHeld[shmId] = TRUE;
+		shmSegments[shmId].numHolders++;
+	}
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::ShmRelease
+//	This address space is going away, and no longer holds shared
+//	segment "shmId" (which it must have detached already).  When the
+//	last holder releases it, the segment's frames are freed.
+//----------------------------------------------------------------------
+
+void AddrSpace::ShmRelease(int shmId) {
+	ShmSegment *seg = &shmSegments[shmId];
+
+	ASSERT(shmHeld[shmId] && shmAttachedAt[shmId] < 0);
+	shmHeld[shmId] = FALSE;
+	if (--seg->numHolders == 0) {
+		for (int i = 0; i < seg->numPages; ++i) {
+			--referCount[seg->frames[i]];	// the segment's own reference
+			sharedFrame[seg->frames[i]] = FALSE;
+		}
+		seg->inUse = FALSE;
+		DEBUG(dbgAddr, "Freed shared segment " << shmId);
+	}
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::IsShared
+//	Return whether physical address "paddr" is in a shared segment.
+//----------------------------------------------------------------------
+
+bool AddrSpace::IsShared(unsigned int paddr) {
+	return sharedFrame[paddr / PageSize];
+}
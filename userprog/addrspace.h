@@ -17,6 +17,8 @@
 #include "filesys.h"
 
 #define UserStackSize		1024 	// increase this as necessary!
+#define MaxShmSegments		8	// shared segments, system-wide
+#define MaxShmPages		16	// pages in one shared segment
 using namespace std;
 class AddrSpace {
 public:
@@ -44,6 +46,18 @@ public:
 	// is 0 for Read, 1 for Write.
 	ExceptionType Translate(unsigned int vaddr, unsigned int *paddr, int mode);
 
+	// Is _vaddr_ backed by memory -- in a frame now, or swapped out?
+	bool IsMapped(unsigned int vaddr);
+	// Is _vaddr_ in a frame now?
+	bool IsResident(unsigned int vaddr);
+
+	// Shared memory: the same physical frames, mapped into
+	// several address spaces.  Shared frames are never swapped.
+	int ShmCreate(int key, int size);		// find or make a segment
+	int ShmAttach(int shmId, unsigned int vaddr);	// map it at vaddr
+	int ShmDetach(int shmId);			// unmap it
+	static bool IsShared(unsigned int paddr);	// in a shared segment?
+
 private:
 	TranslationEntry *pageTable;	// Assume linear page table translation
 	// for now!
@@ -53,6 +67,15 @@ private:
 	void InitRegisters();		// Initialize user-level CPU registers,
 	// before jumping to user code
 
+	int shmAttachedAt[MaxShmSegments];	// first vpn of each attached
+	// segment, or -1
+	bool shmHeld[MaxShmSegments];	// has this address space created or
+	// attached each segment?
+
+	void ShmHold(int shmId);	// keep a segment until we're done
+	void ShmRelease(int shmId);	// done with it; free it if nobody
+	// else holds it
+
 };
 
 struct SwapId {
@@ -68,6 +68,16 @@
 // SC_getThreadID  	18
 // SC_Ipc          	19
 // SC_Clock        	20
+// SC_Pipe         	21
+// SC_ShmCreate    	22
+// SC_ShmAttach    	23
+// SC_ShmDetach    	24
+// SC_SemCreate    	25
+// SC_SemP         	26
+// SC_SemV         	27
+// SC_FutexWait    	28
+// SC_FutexWake    	29
+// SC_Sleep        	30
 // SC_Add			42
 void ExceptionHandler(ExceptionType which) {
 	int type = kernel->machine->ReadRegister(2);
@@ -254,6 +264,352 @@ void ExceptionHandler(ExceptionType which) {
 			ASSERTNOTREACHED();
 			break;
 		}
+		case SC_Close: {
+			// Read the fileID from Register R4
+			int fileID = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "Close " << fileID << "\n");
+
+			// SysClose Systemcall
+			int closeResult = SysClose(fileID);
+			DEBUG(dbgSys, "Close Result " << closeResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, closeResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_Pipe: {
+			// Read the address of the two OpenFileIds from Register R4
+			int fdsAddress = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "Pipe " << fdsAddress << "\n");
+
+			// SysPipe Systemcall
+			int pipeResult = SysPipe(fdsAddress);
+			DEBUG(dbgSys, "Pipe Result " << pipeResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, pipeResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_ShmCreate: {
+			// Read the key and size from Registers R4, R5
+			int key = kernel->machine->ReadRegister(4);
+			int size = kernel->machine->ReadRegister(5);
+			DEBUG(dbgSys, "ShmCreate " << key << " " << size << "\n");
+
+			// SysShmCreate Systemcall
+			int shmCreateResult = SysShmCreate(key, size);
+			DEBUG(dbgSys, "ShmCreate Result " << shmCreateResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, shmCreateResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_ShmAttach: {
+			// Read the shmId and vaddr from Registers R4, R5
+			int shmId = kernel->machine->ReadRegister(4);
+			int vaddr = kernel->machine->ReadRegister(5);
+			DEBUG(dbgSys, "ShmAttach " << shmId << " " << vaddr << "\n");
+
+			// SysShmAttach Systemcall
+			int shmAttachResult = SysShmAttach(shmId, vaddr);
+			DEBUG(dbgSys, "ShmAttach Result " << shmAttachResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, shmAttachResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_ShmDetach: {
+			// Read the shmId from Register R4
+			int shmId = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "ShmDetach " << shmId << "\n");
+
+			// SysShmDetach Systemcall
+			int shmDetachResult = SysShmDetach(shmId);
+			DEBUG(dbgSys, "ShmDetach Result " << shmDetachResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, shmDetachResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_SemCreate: {
+			// Read the key and value from Registers R4, R5
+			int key = kernel->machine->ReadRegister(4);
+			int value = kernel->machine->ReadRegister(5);
+			DEBUG(dbgSys, "SemCreate " << key << " " << value << "\n");
+
+			// SysSemCreate Systemcall
+			int semCreateResult = SysSemCreate(key, value);
+			DEBUG(dbgSys, "SemCreate Result " << semCreateResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, semCreateResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_SemP: {
+			// Read the semId from Register R4
+			int semId = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "SemP " << semId << "\n");
+
+			// SysSemP Systemcall
+			int semPResult = SysSemP(semId);
+			DEBUG(dbgSys, "SemP Result " << semPResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, semPResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_SemV: {
+			// Read the semId from Register R4
+			int semId = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "SemV " << semId << "\n");
+
+			// SysSemV Systemcall
+			int semVResult = SysSemV(semId);
+			DEBUG(dbgSys, "SemV Result " << semVResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, semVResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_FutexWait: {
+			// Read the addr and expected from Registers R4, R5
+			int addr = kernel->machine->ReadRegister(4);
+			int expected = kernel->machine->ReadRegister(5);
+			DEBUG(dbgSys, "FutexWait " << addr << " " << expected << "\n");
+
+			// SysFutexWait Systemcall
+			int futexWaitResult = SysFutexWait(addr, expected);
+			DEBUG(dbgSys, "FutexWait Result " << futexWaitResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, futexWaitResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_FutexWake: {
+			// Read the addr and count from Registers R4, R5
+			int addr = kernel->machine->ReadRegister(4);
+			int count = kernel->machine->ReadRegister(5);
+			DEBUG(dbgSys, "FutexWake " << addr << " " << count << "\n");
+
+			// SysFutexWake Systemcall
+			int futexWakeResult = SysFutexWake(addr, count);
+			DEBUG(dbgSys, "FutexWake Result " << futexWakeResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, futexWakeResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
+		case SC_Sleep: {
+			// Read the ticks from Register R4
+			int ticks = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "Sleep " << ticks << "\n");
+
+			// SysSleep Systemcall
+			int sleepResult = SysSleep(ticks);
+			DEBUG(dbgSys, "Sleep Result " << sleepResult << "\n");
+
+			// Write the the result to Register R2
+			kernel->machine->WriteRegister(2, sleepResult);
+
+			// Modify return point
+			{
+				/* set previous program counter (debugging only)*/
+				kernel->machine->WriteRegister(PrevPCReg,
+						kernel->machine->ReadRegister(PCReg));
+
+				/* set program counter to next instruction (all Instructions are 4 byte wide)*/
+				kernel->machine->WriteRegister(PCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+
+				/* set next program counter for branch execution */
+				kernel->machine->WriteRegister(NextPCReg,
+						kernel->machine->ReadRegister(PCReg) + 4);
+			}
+
+			return;
+			ASSERTNOTREACHED();
+			break;
+		}
 		case SC_Add: {
 			DEBUG(dbgSys,
 					"Add " << kernel->machine->ReadRegister(4) << " + " << kernel->machine->ReadRegister(5) << "\n");
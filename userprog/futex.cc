@@ -0,0 +1,208 @@
+// futex.cc
+//	Routines to put threads to sleep on a word of user memory, and 
+//	to wake them up again.
+//
+//	Checking the word and joining the wait queue happen with 
+//	interrupts disabled, so a Wake can't slip in between them; a 
+//	Wake after that simply V's the waiter's semaphore, so the 
+//	wakeup can't be lost either.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "futex.h"
+#include "main.h"
+#include "syscall.h"
+
+//----------------------------------------------------------------------
+// FutexWaiter::FutexWaiter
+//	Initialize the record of a thread waiting on a futex.
+//
+//	"s" -- the address space, or NULL for a shared futex
+//	"k" -- the virtual (or, for a shared futex, physical) address
+//----------------------------------------------------------------------
+
+FutexWaiter::FutexWaiter(AddrSpace *s, unsigned int k)
+{
+    space = s;
+    key = k;
+    wakeup = new Semaphore("futex", 0);
+}
+
+//----------------------------------------------------------------------
+// FutexWaiter::~FutexWaiter
+//	De-allocate the record of a waiting thread.
+//----------------------------------------------------------------------
+
+FutexWaiter::~FutexWaiter()
+{
+    delete wakeup;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::FutexTable
+//	Initialize the futex wait queues, all empty.
+//----------------------------------------------------------------------
+
+FutexTable::FutexTable()
+{
+    for (int i = 0; i < NumFutexBuckets; i++) {
+	buckets[i] = new List<FutexWaiter *>;
+    }
+}
+
+//----------------------------------------------------------------------
+// FutexTable::~FutexTable
+//	De-allocate the futex wait queues.  Nobody should be waiting.
+//----------------------------------------------------------------------
+
+FutexTable::~FutexTable()
+{
+    for (int i = 0; i < NumFutexBuckets; i++) {
+	delete buckets[i];
+    }
+}
+
+//----------------------------------------------------------------------
+// FutexTable::Name
+//	Work out how to name the futex at user address "addr" in the 
+//	current address space.
+//
+// Returns:
+//	FALSE if "addr" isn't mapped
+//----------------------------------------------------------------------
+
+bool
+FutexTable::Name(int addr, AddrSpace **space, unsigned int *key)
+{
+    AddrSpace *current = kernel->currentThread->space;
+    unsigned int paddr;
+
+    if (!current->IsMapped(addr) ||
+	    current->Translate(addr, &paddr, 0) != NoException) {
+	return FALSE;
+    }
+    if (AddrSpace::IsShared(paddr)) {
+	*space = NULL;
+	*key = paddr;
+    } else {
+	*space = current;
+	*key = addr;
+    }
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::Hash
+//	Pick the wait queue for a futex.
+//----------------------------------------------------------------------
+
+int
+FutexTable::Hash(AddrSpace *space, unsigned int key)
+{
+    return ((key >> 2) ^ (unsigned int)(long) space) % NumFutexBuckets;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::Wait
+//	If the word at "addr" holds "expected", sleep until some other
+//	thread calls Wake on the same address.  Otherwise return at once:
+//	the value has changed since the caller decided to wait.
+//
+// Returns:
+//	0 once woken up, EWOULDBLOCK if the word didn't hold "expected",
+//	or EINVAL/EFAULT for a bad address
+//----------------------------------------------------------------------
+
+int
+FutexTable::Wait(int addr, int expected)
+{
+    AddrSpace *space;
+    unsigned int key;
+    FutexWaiter *waiter;
+    AddrSpace *current = kernel->currentThread->space;
+    int value;
+    IntStatus oldLevel;
+
+    if (addr % 4 != 0) {
+	return EINVAL;
+    }
+
+    // The word's page may be swapped out.  Swapping it back in can
+    // block, and the page can be swapped out again before we run, so
+    // keep at it until the word is in memory with interrupts off.
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    while (!current->IsResident(addr)) {
+	if (!current->IsMapped(addr)) {
+	    (void) kernel->interrupt->SetLevel(oldLevel);
+	    return EFAULT;		// not swapped out; never there
+	}
+	(void) kernel->interrupt->SetLevel(oldLevel);
+	(void) kernel->machine->ReadMem(addr, 4, &value);	// swap it in
+	oldLevel = kernel->interrupt->SetLevel(IntOff);
+    }
+    (void) kernel->machine->ReadMem(addr, 4, &value);
+
+    if (value != expected) {
+	(void) kernel->interrupt->SetLevel(oldLevel);
+	return EWOULDBLOCK;
+    }
+    if (!Name(addr, &space, &key)) {
+	(void) kernel->interrupt->SetLevel(oldLevel);
+	return EFAULT;
+    }
+    waiter = new FutexWaiter(space, key);
+    buckets[Hash(space, key)]->Append(waiter);
+    (void) kernel->interrupt->SetLevel(oldLevel);
+
+    waiter->wakeup->P();		// Wake took us off the queue
+    delete waiter;
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::Wake
+//	Wake up to "count" of the threads waiting on the word at "addr",
+//	oldest first.
+//
+// Returns:
+//	the number of threads woken up, or EINVAL/EFAULT for a bad address
+//----------------------------------------------------------------------
+
+int
+FutexTable::Wake(int addr, int count)
+{
+    AddrSpace *space;
+    unsigned int key;
+    List<FutexWaiter *> *bucket;
+    List<FutexWaiter *> woken;
+    int numWoken = 0;
+    IntStatus oldLevel;
+
+    if (addr % 4 != 0 || count < 0) {
+	return EINVAL;
+    }
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    if (!Name(addr, &space, &key)) {
+	(void) kernel->interrupt->SetLevel(oldLevel);
+	return EFAULT;
+    }
+    bucket = buckets[Hash(space, key)];
+    ListIterator<FutexWaiter *> iter(bucket);
+    for (; !iter.IsDone() && numWoken < count; iter.Next()) {
+	FutexWaiter *waiter = iter.Item();
+	if (waiter->space == space && waiter->key == key) {
+	    woken.Append(waiter);
+	    numWoken++;
+	}
+    }
+    while (!woken.IsEmpty()) {		// can't remove while iterating
+	FutexWaiter *waiter = woken.RemoveFront();
+	bucket->Remove(waiter);
+	waiter->wakeup->V();
+    }
+    (void) kernel->interrupt->SetLevel(oldLevel);
+    return numWoken;
+}
@@ -0,0 +1,64 @@
+// futex.h
+//	Data structures for futexes -- kernel wait queues named by the
+//	address of a word in user memory.  A user-level lock only needs
+//	to trap into the kernel when it has to wait, or when someone is
+//	waiting for it.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "list.h"
+#include "synch.h"
+
+class AddrSpace;
+
+const int NumFutexBuckets = 31;		// wait queues are hashed into
+					// this many lists
+
+// The following class records one thread waiting on a futex.  
+// A futex in private memory is named by its address space and virtual 
+// address; one in a shared memory segment by its physical address, 
+// so that every program that maps the segment finds the same queue.
+
+class FutexWaiter {
+  public:
+    FutexWaiter(AddrSpace *s, unsigned int k);
+    ~FutexWaiter();
+
+    AddrSpace *space;		// NULL if "key" is a physical address
+    unsigned int key;		// the address waited on
+    Semaphore *wakeup;		// V'ed by Wake
+};
+
+// The following class defines the futex operations.  Like Condition
+// variables, a waiter sleeps on a semaphore of its own, which sits on
+// a list until a Wake removes it.
+
+class FutexTable {
+  public:
+    FutexTable();		// no one is waiting
+    ~FutexTable();		// de-allocate the wait queues
+
+    int Wait(int addr, int expected);
+				// Sleep until woken, if the word at
+				// "addr" still holds "expected"
+    int Wake(int addr, int count);
+				// Wake up to "count" threads waiting
+				// on "addr"
+
+  private:
+    List<FutexWaiter *> *buckets[NumFutexBuckets];
+
+    bool Name(int addr, AddrSpace **space, unsigned int *key);
+				// find the name of the futex at "addr"
+    int Hash(AddrSpace *space, unsigned int key);
+				// which bucket does it belong in?
+};
+
+#endif // FUTEX_H
@@ -13,6 +13,9 @@
 
 #include "kernel.h"
 #include "synchconsole.h"
+#include "pipe.h"
+#include "usersem.h"
+#include "futex.h"
 #include "syscall.h"
 #include <unistd.h>
 #include <sys/types.h>
@@ -32,28 +35,143 @@ int SysAdd(int op1, int op2)
 
 int SysRead(int buffer, int size, OpenFileId id)
 {
-	int value;
+	char chunk[ConsoleBlockSize];
+	int done = 0;
 	if(id == ConsoleIn){
-		for (int i = 0; i < size; i ++) {
-			value = kernel->synchConsoleIn->GetChar();
-			kernel->machine->WriteMem(buffer++, 1, value);
+		// take whole runs of buffered input at a time; stop early at EOF
+		while (done < size) {
+			int want = size - done;
+			if (want > ConsoleBlockSize)
+				want = ConsoleBlockSize;
+			int got = kernel->synchConsoleIn->GetBuffer(chunk, want);
+			if (got == 0)
+				break;
+			for (int i = 0; i < got; i ++)
+				kernel->machine->WriteMem(buffer++, 1, chunk[i]);
+			done += got;
 		}
+		return done;
+	}
+	if(kernel->pipeTable->IsPipe(id)){
+		// one bulk copy out of the pipe, then into user memory
+		int want = size;
+		if (want > ConsoleBlockSize)
+			want = ConsoleBlockSize;
+		int got = kernel->pipeTable->Read(id, chunk, want);
+		for (int i = 0; i < got; i ++)
+			kernel->machine->WriteMem(buffer++, 1, chunk[i]);
+		return got;
 	}
 	return size;
 }
 
 int SysWrite(int buffer, int size, OpenFileId id)
 {
+	char chunk[ConsoleBlockSize];
 	int value;
 	if(id == ConsoleOut){
-		for (int i = 0; i < size; i ++) {
-                        kernel->machine->ReadMem(buffer++, 1, &value);
-			kernel->synchConsoleOut->PutChar((char)value);
-                }
+		// copy out of user memory a block at a time, then hand the
+		// whole block to the console; a write is visible on return
+		for (int done = 0; done < size; ) {
+			int count = size - done;
+			if (count > ConsoleBlockSize)
+				count = ConsoleBlockSize;
+			for (int i = 0; i < count; i ++) {
+				kernel->machine->ReadMem(buffer++, 1, &value);
+				chunk[i] = (char)value;
+			}
+			kernel->synchConsoleOut->PutBuffer(chunk, count);
+			done += count;
+		}
+		kernel->synchConsoleOut->Flush();
+	}
+	else if(kernel->pipeTable->IsPipe(id)){
+		// copy out of user memory a block at a time, and hand each
+		// block to the pipe in one piece
+		for (int done = 0; done < size; ) {
+			int count = size - done;
+			if (count > ConsoleBlockSize)
+				count = ConsoleBlockSize;
+			for (int i = 0; i < count; i ++) {
+				kernel->machine->ReadMem(buffer++, 1, &value);
+				chunk[i] = (char)value;
+			}
+			int put = kernel->pipeTable->Write(id, chunk, count);
+			if (put < 0)
+				return (done > 0) ? done : put;
+			done += put;
+			if (put < count)
+				return done;	// reader went away part way
+		}
 	}
 	return size;
 }
 
+int SysClose(OpenFileId id)
+{
+	if(kernel->pipeTable->IsPipe(id)){
+		return kernel->pipeTable->Close(id);
+	}
+	return EBADF;
+}
+
+int SysPipe(int fds)
+{
+	OpenFileId readEnd, writeEnd;
+	int result = kernel->pipeTable->Open(&readEnd, &writeEnd);
+	if(result == 0){
+		kernel->machine->WriteMem(fds, 4, readEnd);
+		kernel->machine->WriteMem(fds + 4, 4, writeEnd);
+	}
+	return result;
+}
+
+int SysShmCreate(int key, int size)
+{
+	return kernel->currentThread->space->ShmCreate(key, size);
+}
+
+int SysShmAttach(int shmId, int vaddr)
+{
+	return kernel->currentThread->space->ShmAttach(shmId, vaddr);
+}
+
+int SysShmDetach(int shmId)
+{
+	return kernel->currentThread->space->ShmDetach(shmId);
+}
+
+int SysSemCreate(int key, int value)
+{
+	return kernel->userSemaphores->Create(key, value);
+}
+
+int SysSemP(int semId)
+{
+	return kernel->userSemaphores->P(semId);
+}
+
+int SysSemV(int semId)
+{
+	return kernel->userSemaphores->V(semId);
+}
+
+int SysFutexWait(int addr, int expected)
+{
+	return kernel->futexTable->Wait(addr, expected);
+}
+
+int SysFutexWake(int addr, int count)
+{
+	return kernel->futexTable->Wake(addr, count);
+}
+
+int SysSleep(int ticks)
+{
+	kernel->alarm->WaitUntil(ticks);
+	return 0;
+}
+
 int SysJoin(SpaceId id)
 {
 	return waitpid(id, NULL, 0);
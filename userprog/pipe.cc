@@ -0,0 +1,369 @@
+// pipe.cc
+//	Routines for pipes, and for the table of open pipes.
+//
+// 	Pipes are implemented "monitor"-style -- each procedure is
+// 	surrounded with a lock acquire and release pair, using condition
+// 	signal and wait for synchronization.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "pipe.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// PipeBuffer::PipeBuffer
+//	Initialize an empty pipe, with both ends open.
+//
+//	"size" -- how many bytes the pipe can hold before writers wait
+//----------------------------------------------------------------------
+
+PipeBuffer::PipeBuffer(int size)
+{
+    ASSERT(size > 0);
+    this->size = size;
+    buffer = new char[size];
+    head = count = 0;
+    readOpen = writeOpen = TRUE;
+    numActive = 0;
+    lock = new Lock("pipe lock");
+    notEmpty = new Condition("pipe not empty");
+    notFull = new Condition("pipe not full");
+}
+
+//----------------------------------------------------------------------
+// PipeBuffer::~PipeBuffer
+//	De-allocate a pipe.  Nobody can be waiting on it, except when
+//	Nachos is halting.
+//----------------------------------------------------------------------
+
+PipeBuffer::~PipeBuffer()
+{
+    delete notFull;
+    delete notEmpty;
+    delete lock;
+    delete [] buffer;
+}
+
+//----------------------------------------------------------------------
+// PipeBuffer::Read
+//	Read bytes out of the pipe.  Wait until there is at least one,
+//	then take as many as are there, up to "numBytes".  The bytes
+//	are copied out in (at most two) contiguous runs.
+//
+//	"into" -- where to put the bytes
+//	"numBytes" -- the most bytes to read
+//
+// Returns:
+//	the number of bytes read, or 0 if the pipe is empty and the
+//	write end has been closed
+//----------------------------------------------------------------------
+
+int
+PipeBuffer::Read(char *into, int numBytes)
+{
+    int done = 0;
+
+    lock->Acquire();
+    while (count == 0 && writeOpen) {
+	notEmpty->Wait(lock);		// wait until the pipe isn't empty
+    }
+    while (done < numBytes && count > 0) {
+	int run = size - head;		// bytes up to the end of the ring
+
+	if (run > count) {
+	    run = count;
+	}
+	if (run > numBytes - done) {
+	    run = numBytes - done;
+	}
+	bcopy(buffer + head, into + done, run);
+	head = (head + run) % size;
+	count -= run;
+	done += run;
+    }
+    if (done > 0) {
+	notFull->Broadcast(lock);	// wake up writers waiting for room
+    }
+    lock->Release();
+    return done;
+}
+
+//----------------------------------------------------------------------
+// PipeBuffer::Write
+//	Write bytes into the pipe, waiting for room as needed.  The
+//	bytes are copied in (at most two) contiguous runs each time
+//	there is room.
+//
+//	"from" -- the bytes to write
+//	"numBytes" -- how many of them
+//
+// Returns:
+//	the number of bytes written, or EPIPE if the read end was
+//	closed before any could be written
+//----------------------------------------------------------------------
+
+int
+PipeBuffer::Write(char *from, int numBytes)
+{
+    int done = 0;
+
+    lock->Acquire();
+    while (done < numBytes && readOpen) {
+	if (count == size) {
+	    notFull->Wait(lock);	// wait until there is room
+	    continue;
+	}
+	int tail = (head + count) % size;
+	int run = (tail >= head) ? size - tail : head - tail;
+
+	if (run > numBytes - done) {
+	    run = numBytes - done;
+	}
+	bcopy(from + done, buffer + tail, run);
+	count += run;
+	done += run;
+	notEmpty->Broadcast(lock);	// wake up readers
+    }
+    lock->Release();
+    if (done == 0 && numBytes > 0) {
+	return EPIPE;
+    }
+    return done;
+}
+
+//----------------------------------------------------------------------
+// PipeBuffer::CloseRead
+//	Close the read end.  Writers waiting for room give up.
+//----------------------------------------------------------------------
+
+void
+PipeBuffer::CloseRead()
+{
+    lock->Acquire();
+    readOpen = FALSE;
+    notFull->Broadcast(lock);
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// PipeBuffer::CloseWrite
+//	Close the write end.  Readers waiting on an empty pipe get EOF.
+//----------------------------------------------------------------------
+
+void
+PipeBuffer::CloseWrite()
+{
+    lock->Acquire();
+    writeOpen = FALSE;
+    notEmpty->Broadcast(lock);
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// PipeTable::PipeTable
+//	Initialize the table of open pipes, with none open.
+//----------------------------------------------------------------------
+
+PipeTable::PipeTable()
+{
+    for (int i = 0; i < MaxPipes; i++) {
+	pipes[i] = NULL;
+    }
+}
+
+//----------------------------------------------------------------------
+// PipeTable::~PipeTable
+//	De-allocate any pipes still open.
+//----------------------------------------------------------------------
+
+PipeTable::~PipeTable()
+{
+    for (int i = 0; i < MaxPipes; i++) {
+	delete pipes[i];
+    }
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Open
+//	Create a new pipe, and return the ids of its two ends.
+//
+//	"readEnd" -- set to the id to read the pipe with
+//	"writeEnd" -- set to the id to write the pipe with
+//
+// Returns:
+//	0, or ENFILE if too many pipes are open
+//----------------------------------------------------------------------
+
+int
+PipeTable::Open(OpenFileId *readEnd, OpenFileId *writeEnd)
+{
+    for (int i = 0; i < MaxPipes; i++) {
+	if (pipes[i] == NULL) {
+	    pipes[i] = new PipeBuffer();
+	    *readEnd = FirstPipeId + 2 * i;
+	    *writeEnd = FirstPipeId + 2 * i + 1;
+	    return 0;
+	}
+    }
+    return ENFILE;
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Lookup
+//	Find the pipe that an id refers to, if that end is still open.
+//
+//	"id" -- the pipe end
+//	"isWriteEnd" -- set to whether "id" is the write end
+//----------------------------------------------------------------------
+
+PipeBuffer *
+PipeTable::Lookup(OpenFileId id, bool *isWriteEnd)
+{
+    int i = (id - FirstPipeId) / 2;
+    PipeBuffer *pipe;
+
+    if (id < FirstPipeId || i >= MaxPipes || pipes[i] == NULL) {
+	return NULL;
+    }
+    pipe = pipes[i];
+    *isWriteEnd = ((id - FirstPipeId) % 2 == 1);
+    if (*isWriteEnd ? !pipe->IsWriteOpen() : !pipe->IsReadOpen()) {
+	return NULL;			// this end has been closed
+    }
+    return pipe;
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Use
+//	Find the pipe that an id refers to, as Lookup does, and count
+//	the current thread as using it, so it isn't de-allocated while
+//	the thread waits inside it.  Every successful call must be
+//	matched by a call to Done.
+//
+//	Interrupts are turned off, so the pipe can't be closed between
+//	looking it up and entering it.
+//----------------------------------------------------------------------
+
+PipeBuffer *
+PipeTable::Use(OpenFileId id, bool *isWriteEnd)
+{
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    PipeBuffer *pipe = Lookup(id, isWriteEnd);
+
+    if (pipe != NULL) {
+	pipe->Enter();
+    }
+    (void) kernel->interrupt->SetLevel(oldLevel);
+    return pipe;
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Done
+//	The current thread is done using a pipe.  If both ends have
+//	been closed, and no other thread is using it, de-allocate it.
+//----------------------------------------------------------------------
+
+void
+PipeTable::Done(PipeBuffer *pipe)
+{
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    bool last = pipe->Leave();
+
+    (void) kernel->interrupt->SetLevel(oldLevel);
+    if (last) {
+	delete pipe;
+    }
+}
+
+//----------------------------------------------------------------------
+// PipeTable::IsPipe
+//	Return whether "id" is an open pipe end.
+//----------------------------------------------------------------------
+
+bool
+PipeTable::IsPipe(OpenFileId id)
+{
+    bool isWriteEnd;
+
+    return (Lookup(id, &isWriteEnd) != NULL);
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Read
+//	Read from the pipe "id" is the read end of.  See PipeBuffer::Read.
+//	Returns EBADF if "id" is not an open read end.
+//----------------------------------------------------------------------
+
+int
+PipeTable::Read(OpenFileId id, char *into, int numBytes)
+{
+    bool isWriteEnd;
+    PipeBuffer *pipe = Use(id, &isWriteEnd);
+    int result;
+
+    if (pipe == NULL) {
+	return EBADF;
+    }
+    result = isWriteEnd ? EBADF : pipe->Read(into, numBytes);
+    Done(pipe);
+    return result;
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Write
+//	Write to the pipe "id" is the write end of.  See PipeBuffer::Write.
+//	Returns EBADF if "id" is not an open write end.
+//----------------------------------------------------------------------
+
+int
+PipeTable::Write(OpenFileId id, char *from, int numBytes)
+{
+    bool isWriteEnd;
+    PipeBuffer *pipe = Use(id, &isWriteEnd);
+    int result;
+
+    if (pipe == NULL) {
+	return EBADF;
+    }
+    result = !isWriteEnd ? EBADF : pipe->Write(from, numBytes);
+    Done(pipe);
+    return result;
+}
+
+//----------------------------------------------------------------------
+// PipeTable::Close
+//	Close one end of a pipe.  Once both ends are closed, the pipe
+//	is taken out of the table, and de-allocated when the last
+//	thread waiting inside it has left (see PipeTable::Done).
+//
+// Returns:
+//	1, or EBADF if "id" is not an open pipe end
+//----------------------------------------------------------------------
+
+int
+PipeTable::Close(OpenFileId id)
+{
+    bool isWriteEnd;
+    PipeBuffer *pipe = Use(id, &isWriteEnd);
+    int i = (id - FirstPipeId) / 2;
+    IntStatus oldLevel;
+
+    if (pipe == NULL) {
+	return EBADF;
+    }
+    if (isWriteEnd) {
+	pipe->CloseWrite();
+    } else {
+	pipe->CloseRead();
+    }
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    if (!pipe->IsReadOpen() && !pipe->IsWriteOpen() && pipes[i] == pipe) {
+	pipes[i] = NULL;		// the slot can be reused right away
+    }
+    (void) kernel->interrupt->SetLevel(oldLevel);
+    Done(pipe);
+    return 1;
+}
@@ -0,0 +1,105 @@
+// pipe.h
+//	Data structures for pipes -- bounded in-kernel byte streams
+//	that connect a writer to a reader, without going through the
+//	disk or the console.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef PIPE_H
+#define PIPE_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "synch.h"
+#include "syscall.h"
+
+const int PipeSize = 1024;	// bytes buffered in a pipe by default
+const int MaxPipes = 16;	// pipes open at once, system-wide
+
+// The following class defines the buffer behind a pipe: a ring buffer with a read end
+// and a write end.  It is implemented "monitor"-style, like SynchList:
+// 	1. A reader waits until there is at least one byte to read,
+//	or until the write end has been closed (EOF).
+//	2. A writer copies in as much as there is room for, and waits
+//	for more room until it has written everything, or until the
+//	read end has been closed (broken pipe).
+//
+// Data is moved in contiguous runs, not a byte at a time.
+//
+// A thread can be waiting inside Read or Write when another thread
+// closes the last open end, so the pipe counts the threads using it,
+// and is only de-allocated once both ends are closed and the last of
+// them has left.
+
+class PipeBuffer {
+  public:
+    PipeBuffer(int size = PipeSize);	// initialize an empty pipe
+    ~PipeBuffer();		// de-allocate the pipe
+
+    int Read(char *into, int numBytes);
+				// Read up to "numBytes", waiting until
+				// some are available; returns 0 at EOF
+    int Write(char *from, int numBytes);
+				// Write "numBytes", waiting for room;
+				// returns EPIPE if there is no reader
+
+    void CloseRead();		// the reader is done with the pipe
+    void CloseWrite();		// the writer is done with the pipe
+    bool IsReadOpen() { return readOpen; }
+    bool IsWriteOpen() { return writeOpen; }
+
+    void Enter() { numActive++; }
+				// a thread is about to use the pipe
+    bool Leave() { numActive--;
+		   return (numActive == 0 && !readOpen && !writeOpen); }
+				// that thread is done; returns TRUE if
+				// the pipe can now be de-allocated.
+				// Both are called with interrupts off.
+
+  private:
+    char *buffer;		// the bytes in the pipe
+    int size;			// size of "buffer"
+    int head;			// where the next byte is read from
+    int count;			// number of bytes in "buffer"
+    bool readOpen;		// is the read end still open?
+    bool writeOpen;		// is the write end still open?
+    int numActive;		// threads inside Read, Write or a Close
+    Lock *lock;			// one reader or writer at a time
+    Condition *notEmpty;	// readers wait here for bytes
+    Condition *notFull;		// writers wait here for room
+};
+
+// The following class keeps track of the open pipes, and maps their
+// ends to OpenFileIds.  Pipe ends are numbered after ConsoleIn and
+// ConsoleOut; end "2*i + FirstPipeId" reads pipe i, and the next id
+// writes it.
+
+const OpenFileId FirstPipeId = 2;
+
+class PipeTable {
+  public:
+    PipeTable();		// no pipes open yet
+    ~PipeTable();		// close any pipes left open
+
+    int Open(OpenFileId *readEnd, OpenFileId *writeEnd);
+				// Create a pipe; returns 0, or a
+				// negative error code
+    bool IsPipe(OpenFileId id);	// is "id" an open pipe end?
+    int Read(OpenFileId id, char *into, int numBytes);
+    int Write(OpenFileId id, char *from, int numBytes);
+    int Close(OpenFileId id);	// returns 1, or a negative error code
+
+  private:
+    PipeBuffer *pipes[MaxPipes];	// the open pipes; NULL if unused
+
+    PipeBuffer *Lookup(OpenFileId id, bool *isWriteEnd);
+				// find the pipe an open end belongs to
+    PipeBuffer *Use(OpenFileId id, bool *isWriteEnd);
+				// Lookup, and Enter the pipe
+    void Done(PipeBuffer *pipe);	// Leave the pipe, de-allocating it if
+				// it was the last one out
+};
+
+#endif // PIPE_H
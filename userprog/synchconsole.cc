@@ -15,13 +15,20 @@
 //
 //      "inputFile" -- if NULL, use stdin as console device
 //              otherwise, read from this file
+//	"bufferSize" -- how many characters to take from the device at once
 //----------------------------------------------------------------------
 
-SynchConsoleInput::SynchConsoleInput(char *inputFile)
+SynchConsoleInput::SynchConsoleInput(char *inputFile, int bufferSize)
 {
+    ASSERT(bufferSize > 0 && bufferSize <= ConsoleBlockSize);
     consoleInput = new ConsoleInput(inputFile, this);
     lock = new Lock("console in");
     waitFor = new Semaphore("console in", 0);
+    this->bufferSize = bufferSize;
+    buffer = new char[bufferSize];
+    numBuffered = nextBuffered = 0;
+    deviceHasMore = FALSE;
+    atEOF = FALSE;
 }
 
 //----------------------------------------------------------------------
@@ -34,6 +41,41 @@ SynchConsoleInput::~SynchConsoleInput()
     delete consoleInput; 
     delete lock; 
     delete waitFor;
+    delete [] buffer;
+}
+
+//----------------------------------------------------------------------
+// SynchConsoleInput::FillBuffer
+//      Wait for the keyboard to deliver its next block of characters.
+//	Returns FALSE at end of file.  Caller must hold the lock, and 
+//	the buffer must be empty.
+//
+//	The device interrupts once per block, so we wait exactly once
+//	per block: only when the last one has been taken in full.  A
+//	new block can arrive before we get back here, and its interrupt
+//	has to be waited for, or a later wait would not be matched with
+//	a block, and would look like end of file.
+//----------------------------------------------------------------------
+
+bool
+SynchConsoleInput::FillBuffer()
+{
+    ASSERT(lock->IsHeldByCurrentThread());
+    ASSERT(nextBuffered == numBuffered);
+    if (atEOF) {
+	return FALSE;
+    }
+    if (!deviceHasMore) {
+	waitFor->P();	// wait for EOF or a block to be available.
+    }			// else, rest of a block we already waited for
+    numBuffered = consoleInput->GetBlock(buffer, bufferSize);
+    nextBuffered = 0;
+    deviceHasMore = consoleInput->HasMore();
+    if (numBuffered == 0) {
+	atEOF = TRUE;	// the device won't interrupt us again
+	return FALSE;
+    }
+    return TRUE;
 }
 
 //----------------------------------------------------------------------
@@ -44,15 +86,47 @@ SynchConsoleInput::~SynchConsoleInput()
 char
 SynchConsoleInput::GetChar()
 {
-    char ch;
+    char ch = EOF;
 
     lock->Acquire();
-    waitFor->P();	// wait for EOF or a char to be available.
-    ch = consoleInput->GetChar();
+    if (nextBuffered < numBuffered || FillBuffer()) {
+	ch = buffer[nextBuffered++];
+    }
     lock->Release();
     return ch;
 }
 
+//----------------------------------------------------------------------
+// SynchConsoleInput::GetBuffer
+//      Read a run of characters typed at the keyboard.  Waits only
+//	if nothing has been buffered yet; otherwise returns what is
+//	already here, up to and including the first newline.
+//
+//	"into" -- where to put the characters
+//	"maxChars" -- the most characters to return
+//
+//	Returns the number of characters read, 0 at EOF.
+//----------------------------------------------------------------------
+
+int
+SynchConsoleInput::GetBuffer(char *into, int maxChars)
+{
+    int count = 0;
+
+    lock->Acquire();
+    if (nextBuffered < numBuffered || FillBuffer()) {
+	while (count < maxChars && nextBuffered < numBuffered) {
+	    char ch = buffer[nextBuffered++];
+	    into[count++] = ch;
+	    if (ch == '\n') {
+		break;
+	    }
+	}
+    }
+    lock->Release();
+    return count;
+}
+
 //----------------------------------------------------------------------
 // SynchConsoleInput::CallBack
 //      Interrupt handler called when keystroke is hit; wake up
@@ -71,18 +145,26 @@ SynchConsoleInput::CallBack()
 //
 //      "outputFile" -- if NULL, use stdout as console device
 //              otherwise, read from this file
+//	"bufferSize" -- how many characters to collect before sending them
 //----------------------------------------------------------------------
 
-SynchConsoleOutput::SynchConsoleOutput(char *outputFile)
+SynchConsoleOutput::SynchConsoleOutput(char *outputFile, int bufferSize)
 {
+    ASSERT(bufferSize > 0 && bufferSize <= ConsoleBlockSize);
     consoleOutput = new ConsoleOutput(outputFile, this);
     lock = new Lock("console out");
     waitFor = new Semaphore("console out", 0);
+    this->bufferSize = bufferSize;
+    buffer = new char[bufferSize];
+    numBuffered = 0;
 }
 
 //----------------------------------------------------------------------
 // SynchConsoleOutput::~SynchConsoleOutput
 //      Deallocate data structures for synchronized access to the keyboard
+//
+//	By now the interrupt system is gone, so anything still buffered
+//	is lost; callers must Flush before Nachos halts.
 //----------------------------------------------------------------------
 
 SynchConsoleOutput::~SynchConsoleOutput()
@@ -90,19 +172,85 @@ SynchConsoleOutput::~SynchConsoleOutput()
     delete consoleOutput; 
     delete lock; 
     delete waitFor;
+    delete [] buffer;
+}
+
+//----------------------------------------------------------------------
+// SynchConsoleOutput::FlushBuffer
+//      Send whatever is buffered to the display as one block, and 
+//	wait for the transfer to complete.  Caller must hold the lock.
+//----------------------------------------------------------------------
+
+void
+SynchConsoleOutput::FlushBuffer()
+{
+    ASSERT(lock->IsHeldByCurrentThread());
+    if (numBuffered > 0) {
+	consoleOutput->PutBlock(buffer, numBuffered);
+	waitFor->P();
+	numBuffered = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// SynchConsoleOutput::Append
+//      Add a character to the output buffer; the buffer goes out to
+//	the display at the end of each line, or when it is full.
+//	Caller must hold the lock.
+//----------------------------------------------------------------------
+
+void
+SynchConsoleOutput::Append(char ch)
+{
+    buffer[numBuffered++] = ch;
+    if (ch == '\n' || numBuffered == bufferSize) {
+	FlushBuffer();
+    }
 }
 
 //----------------------------------------------------------------------
 // SynchConsoleOutput::PutChar
 //      Write a character to the console display, waiting if necessary.
+//	The character may sit in the buffer until the end of the line.
 //----------------------------------------------------------------------
 
 void
 SynchConsoleOutput::PutChar(char ch)
 {
     lock->Acquire();
-    consoleOutput->PutChar(ch);
-    waitFor->P();
+    Append(ch);
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// SynchConsoleOutput::PutBuffer
+//      Write a run of characters to the console display, one block
+//	per line (or per full buffer).
+//
+//	"from" -- the characters to write
+//	"numChars" -- how many of them
+//----------------------------------------------------------------------
+
+void
+SynchConsoleOutput::PutBuffer(char *from, int numChars)
+{
+    lock->Acquire();
+    for (int i = 0; i < numChars; i++) {
+	Append(from[i]);
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// SynchConsoleOutput::Flush
+//      Push any partial line out to the console display.
+//----------------------------------------------------------------------
+
+void
+SynchConsoleOutput::Flush()
+{
+    lock->Acquire();
+    FlushBuffer();
     lock->Release();
 }
 
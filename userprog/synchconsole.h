@@ -18,35 +18,62 @@
 #include "synch.h"
 
 // The following two classes define synchronized input and output to
-// a console device
+// a console device.
+//
+// Both sides are buffered: input is taken from the device a block at a
+// time, and output is collected until a newline is written, the buffer
+// fills up, or Flush is called, and then sent to the device as a block.
+// "bufferSize" is the size of that buffer (at most ConsoleBlockSize).
 
 class SynchConsoleInput : public CallBackObj {
   public:
-    SynchConsoleInput(char *inputFile); // Initialize the console device
+    SynchConsoleInput(char *inputFile, int bufferSize = ConsoleBlockSize);
+				// Initialize the console device
     ~SynchConsoleInput();		// Deallocate console device
 
     char GetChar();		// Read a character, waiting if necessary
+    int GetBuffer(char *into, int maxChars);
+				// Read up to "maxChars" characters, stopping
+				// after a newline; waits only if nothing
+				// is buffered.  Returns 0 at EOF.
     
   private:
     ConsoleInput *consoleInput;	// the hardware keyboard
     Lock *lock;			// only one reader at a time
     Semaphore *waitFor;		// wait for callBack
+    char *buffer;		// characters read but not yet consumed
+    int bufferSize;		// size of "buffer"
+    int numBuffered;		// number of valid characters in "buffer"
+    int nextBuffered;		// next character to hand out
+    bool deviceHasMore;		// does the device still hold part of
+				// a block we have already waited for?
+    bool atEOF;			// has the device reported end of file?
 
+    bool FillBuffer();		// wait for the next block from the device
     void CallBack();		// called when a keystroke is available
 };
 
 class SynchConsoleOutput : public CallBackObj {
   public:
-    SynchConsoleOutput(char *outputFile); // Initialize the console device
+    SynchConsoleOutput(char *outputFile, int bufferSize = ConsoleBlockSize);
+				// Initialize the console device
     ~SynchConsoleOutput();
 
     void PutChar(char ch);	// Write a character, waiting if necessary
+    void PutBuffer(char *from, int numChars);
+				// Write a run of characters
+    void Flush();		// Push out any buffered characters
     
   private:
     ConsoleOutput *consoleOutput;// the hardware display
     Lock *lock;			// only one writer at a time
     Semaphore *waitFor;		// wait for callBack
+    char *buffer;		// characters not yet sent to the display
+    int bufferSize;		// size of "buffer"
+    int numBuffered;		// number of characters in "buffer"
 
+    void Append(char ch);	// add to the buffer, sending it if needed
+    void FlushBuffer();		// send the buffer; caller holds the lock
     void CallBack();		// called when more data can be written
 };
 
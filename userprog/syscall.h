@@ -39,6 +39,16 @@
 #define SC_getThreadID  18
 #define SC_Ipc          19
 #define SC_Clock        20
+#define SC_Pipe         21
+#define SC_ShmCreate    22
+#define SC_ShmAttach    23
+#define SC_ShmDetach    24
+#define SC_SemCreate    25
+#define SC_SemP         26
+#define SC_SemV         27
+#define SC_FutexWait    28
+#define SC_FutexWake    29
+#define SC_Sleep        30
 
 #define SC_Add		42
 
@@ -159,6 +169,77 @@ int Delete(char* name);
  */
 int Close(OpenFileId id);
 
+/* Create a pipe: a bounded in-kernel buffer that one program writes and
+ * another reads, without going through a file or the console.
+ * "fds[0]" is set to the end to Read from, "fds[1]" to the end to Write to.
+ * Read waits until at least one byte is available, and returns 0 once
+ * the pipe is empty and its write end has been closed.  Write waits for
+ * room, and returns EPIPE if the read end has been closed.
+ * Return 0 on success, negative error code on failure
+ */
+int Pipe(OpenFileId fds[2]);
+
+
+/* Shared memory: ShmCreate, ShmAttach, ShmDetach.  Two programs that
+ * attach the same segment see the same physical memory, so data can be
+ * exchanged without copying it through a file, a pipe or the console.
+ */
+
+/* Find the shared memory segment named "key", or create one of "size"
+ * bytes (zero-filled) if no program has created it yet.  A segment lasts
+ * until every program that created or attached it has exited.
+ * Return the segment id on success, negative error code on failure
+ */
+int ShmCreate(int key, int size);
+
+/* Map shared segment "shmId" into this address space at "addr", which
+ * must be page aligned and not already in use.
+ * Return 0 on success, negative error code on failure
+ */
+int ShmAttach(int shmId, void *addr);
+
+/* Unmap shared segment "shmId".  The segment, and what it holds, stays
+ * around for other programs to attach until this program exits.
+ * Return 0 on success, negative error code on failure
+ */
+int ShmDetach(int shmId);
+
+/* Semaphores, for user programs to coordinate with each other (for
+ * instance, around a shared memory segment).
+ */
+
+/* Find the semaphore named "key", or create it with "value".
+ * Return the semaphore id on success, negative error code on failure
+ */
+int SemCreate(int key, int value);
+
+/* Wait on, or signal, semaphore "semId".
+ * Return 0 on success, negative error code on failure
+ */
+int SemP(int semId);
+int SemV(int semId);
+
+/* Futexes: wait queues named by the address of a word of user memory,
+ * for building user-level locks that only trap into the kernel when 
+ * they have to wait, or when someone is waiting on them.
+ */
+
+/* If the word at "addr" still holds "expected", sleep until FutexWake
+ * is called on "addr".  Return 0 once woken, EWOULDBLOCK if the word
+ * didn't hold "expected", negative error code on failure
+ */
+int FutexWait(int *addr, int expected);
+
+/* Wake up to "count" threads sleeping in FutexWait on "addr".
+ * Return the number woken, negative error code on failure
+ */
+int FutexWake(int *addr, int count);
+
+/* Suspend the current thread for at least "ticks" ticks of simulated
+ * time, without using the CPU.  Return 0
+ */
+int Sleep(int ticks);
+
 
 /* User-level thread operations: Fork and Yield.  To allow multiple
  * threads to run within a user program. 
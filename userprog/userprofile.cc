@@ -0,0 +1,371 @@
+// userprofile.cc
+//	Routines to sample where user programs spend their time, and
+//	report the hot spots by function and by instruction.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "userprofile.h"
+#include "main.h"
+
+const int InitialProfileTable = 256;	// starting size of the sample table
+const int NumReported = 20;		// hot spots listed in each report
+
+//----------------------------------------------------------------------
+// Insert
+//	Add "count" samples for a program counter and return address to
+//	a hash table, using an unused entry if they aren't there yet.
+//	The table must have an unused entry.
+//
+// Returns:
+//	TRUE, if an unused entry was taken
+//----------------------------------------------------------------------
+
+static bool
+Insert(ProfileSample *table, int size, unsigned int pc, unsigned int ra,
+								int count)
+{
+    int i = ((pc * 2654435761U) ^ (ra * 40503U)) & (size - 1);
+
+    while (table[i].count != 0) {
+	if (table[i].pc == pc && table[i].ra == ra) {
+	    table[i].count += count;
+	    return FALSE;
+	}
+	i = (i + 1) & (size - 1);
+    }
+    table[i].pc = pc;
+    table[i].ra = ra;
+    table[i].count = count;
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// NewTable
+//	Allocate a hash table of samples, with every entry unused.
+//----------------------------------------------------------------------
+
+static ProfileSample *
+NewTable(int size)
+{
+    ProfileSample *table = new ProfileSample[size];
+
+    for (int i = 0; i < size; i++) {
+	table[i].count = 0;
+    }
+    return table;
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::UserProfiler
+//	Initialize the profiler, with no samples and no symbols.
+//
+//	"interval" -- how many user instructions between samples
+//----------------------------------------------------------------------
+
+UserProfiler::UserProfiler(int interval)
+{
+    ASSERT(interval > 0);
+    this->interval = interval;
+    countdown = interval;
+    numSamples = 0;
+    tableSize = InitialProfileTable;
+    table = NewTable(tableSize);
+    numEntries = 0;
+    symbols = NULL;
+    numSymbols = 0;
+    foldedName = NULL;
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::~UserProfiler
+//	De-allocate the samples and the symbols.
+//----------------------------------------------------------------------
+
+UserProfiler::~UserProfiler()
+{
+    delete [] table;
+    for (int i = 0; i < numSymbols; i++) {
+	delete [] symbols[i].name;
+    }
+    delete [] symbols;
+    delete [] foldedName;
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::LoadSymbols
+//	Read the function symbols of the program being profiled, from
+//	the "nm -n" output the test/ Makefile leaves next to it.  Each
+//	line is an address, a symbol type, and a name; only text
+//	symbols (functions) are kept.
+//
+//	"programName" -- the NOFF file; "prog.noff" has its symbols in
+//		"prog.sym", and its folded stacks go to "prog.folded"
+//----------------------------------------------------------------------
+
+void
+UserProfiler::LoadSymbols(char *programName)
+{
+    int length = strlen(programName);
+    char *symName, *contents, *line, *next;
+    char name[100], type;
+    unsigned int address;
+    int fd, size, maxSymbols;
+
+    if (length > 5 && strcmp(programName + length - 5, ".noff") == 0) {
+	length -= 5;
+    }
+    symName = new char[length + 5];
+    sprintf(symName, "%.*s.sym", length, programName);
+    foldedName = new char[length + 8];
+    sprintf(foldedName, "%.*s.folded", length, programName);
+
+    fd = OpenForReadWrite(symName, FALSE);
+    if (fd < 0) {
+	std::cout << "No symbols for the profiler in " << symName << "\n";
+	delete [] symName;
+	return;
+    }
+    delete [] symName;
+    Lseek(fd, 0, SEEK_END);
+    size = Tell(fd);
+    Lseek(fd, 0, SEEK_SET);
+    contents = new char[size + 1];
+    Read(fd, contents, size);
+    contents[size] = '\0';
+    Close(fd);
+
+    maxSymbols = 1;			// at most one symbol per line
+    for (int i = 0; i < size; i++) {
+	if (contents[i] == '\n') {
+	    maxSymbols++;
+	}
+    }
+    symbols = new ProfileSymbol[maxSymbols];
+    for (line = contents; line != NULL && *line != '\0'; line = next) {
+	next = strchr(line, '\n');
+	if (next != NULL) {
+	    *next++ = '\0';
+	}
+	if (sscanf(line, "%x %c %99s", &address, &type, name) != 3
+		|| (type != 'T' && type != 't')) {
+	    continue;
+	}
+	// keep the symbols sorted by address, in case nm didn't
+	int i = numSymbols++;
+	while (i > 0 && symbols[i - 1].address > address) {
+	    symbols[i] = symbols[i - 1];
+	    i--;
+	}
+	symbols[i].address = address;
+	symbols[i].name = new char[strlen(name) + 1];
+	strcpy(symbols[i].name, name);
+    }
+    delete [] contents;
+    DEBUG(dbgAddr, "Profiler loaded " << numSymbols << " symbols");
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::Sample
+//	Record where the running user program is, and start counting
+//	down to the next sample.
+//----------------------------------------------------------------------
+
+void
+UserProfiler::Sample()
+{
+    Machine *machine = kernel->machine;
+
+    countdown = interval;
+    numSamples++;
+    Record(machine->ReadRegister(PCReg), machine->ReadRegister(RetAddrReg),
+									1);
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::Record
+//	Add samples to the hash table, doubling it first if it is half
+//	full.
+//----------------------------------------------------------------------
+
+void
+UserProfiler::Record(unsigned int pc, unsigned int ra, int count)
+{
+    if (2 * (numEntries + 1) > tableSize) {
+	ProfileSample *old = table;
+	int oldSize = tableSize;
+
+	tableSize *= 2;
+	table = NewTable(tableSize);
+	for (int i = 0; i < oldSize; i++) {
+	    if (old[i].count != 0) {
+		Insert(table, tableSize, old[i].pc, old[i].ra, old[i].count);
+	    }
+	}
+	delete [] old;
+    }
+    if (Insert(table, tableSize, pc, ra, count)) {
+	numEntries++;
+    }
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::FindSymbol
+//	Find the function that holds an address: the last one that
+//	starts at or before it.
+//
+// Returns:
+//	The function's index in "symbols"; -1 if there is none
+//----------------------------------------------------------------------
+
+int
+UserProfiler::FindSymbol(unsigned int address)
+{
+    int low = 0, high = numSymbols - 1, mid;
+
+    if (numSymbols == 0 || address < symbols[0].address) {
+	return -1;
+    }
+    while (low < high) {		// symbols[low] starts at or before
+	mid = (low + high + 1) / 2;	// "address"; find the last such
+	if (symbols[mid].address <= address) {
+	    low = mid;
+	} else {
+	    high = mid - 1;
+	}
+    }
+    return low;
+}
+
+//----------------------------------------------------------------------
+// PrintLine
+//	Print one line of the hot spot report.
+//----------------------------------------------------------------------
+
+static void
+PrintLine(int count, int total, const char *label)
+{
+    char line[200];
+
+    sprintf(line, "%6.2f%% %8d  %s\n", (100.0 * count) / total, count, label);
+    std::cout << line;
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::Print
+//	Print the hot spots: the functions, then the instructions, where
+//	the most samples fell.  Then write the folded stacks.
+//----------------------------------------------------------------------
+
+void
+UserProfiler::Print()
+{
+    int *perSymbol = new int[numSymbols + 1];	// last is "unknown"
+    ProfileSample *perPc = NewTable(tableSize);
+    char label[200];
+    int best, sym;
+
+    std::cout << "User profile: " << numSamples << " samples, one every "
+	      << interval << " instructions\n";
+    if (numSamples == 0) {
+	delete [] perSymbol;
+	delete [] perPc;
+	return;
+    }
+
+    for (int i = 0; i <= numSymbols; i++) {
+	perSymbol[i] = 0;
+    }
+    for (int i = 0; i < tableSize; i++) {
+	if (table[i].count != 0) {
+	    sym = FindSymbol(table[i].pc);
+	    perSymbol[(sym < 0) ? numSymbols : sym] += table[i].count;
+	    Insert(perPc, tableSize, table[i].pc, 0, table[i].count);
+	}
+    }
+
+    std::cout << "Hot functions:\n";
+    for (int n = 0; n < NumReported; n++) {
+	best = 0;
+	for (int i = 1; i <= numSymbols; i++) {
+	    if (perSymbol[i] > perSymbol[best]) {
+		best = i;
+	    }
+	}
+	if (perSymbol[best] == 0) {
+	    break;
+	}
+	PrintLine(perSymbol[best], numSamples,
+		(best == numSymbols) ? "(unknown)" : symbols[best].name);
+	perSymbol[best] = 0;
+    }
+
+    std::cout << "Hot instructions:\n";
+    for (int n = 0; n < NumReported; n++) {
+	best = 0;
+	for (int i = 1; i < tableSize; i++) {
+	    if (perPc[i].count > perPc[best].count) {
+		best = i;
+	    }
+	}
+	if (perPc[best].count == 0) {
+	    break;
+	}
+	sym = FindSymbol(perPc[best].pc);
+	if (sym < 0) {
+	    sprintf(label, "0x%x", perPc[best].pc);
+	} else {
+	    sprintf(label, "0x%x %s+0x%x", perPc[best].pc, symbols[sym].name,
+			perPc[best].pc - symbols[sym].address);
+	}
+	PrintLine(perPc[best].count, numSamples, label);
+	perPc[best].count = 0;
+    }
+    delete [] perSymbol;
+    delete [] perPc;
+
+    WriteFolded();
+}
+
+//----------------------------------------------------------------------
+// UserProfiler::WriteFolded
+//	Write the samples as folded stacks -- "caller;callee count" --
+//	for flame graph tools, which add up repeated stacks.  Samples
+//	whose return address doesn't point into another function have
+//	no caller.
+//----------------------------------------------------------------------
+
+void
+UserProfiler::WriteFolded()
+{
+    char line[300], callee[100], caller[100];
+    int fd, sym, callerSym;
+
+    if (foldedName == NULL) {
+	return;
+    }
+    fd = OpenForWrite(foldedName);
+    for (int i = 0; i < tableSize; i++) {
+	if (table[i].count == 0) {
+	    continue;
+	}
+	sym = FindSymbol(table[i].pc);
+	callerSym = FindSymbol(table[i].ra);
+	if (sym < 0) {
+	    sprintf(callee, "0x%x", table[i].pc);
+	} else {
+	    sprintf(callee, "%.99s", symbols[sym].name);
+	}
+	if (callerSym < 0 || callerSym == sym) {
+	    sprintf(line, "%s %d\n", callee, table[i].count);
+	} else {
+	    sprintf(caller, "%.99s", symbols[callerSym].name);
+	    sprintf(line, "%s;%s %d\n", caller, callee, table[i].count);
+	}
+	WriteFile(fd, line, strlen(line));
+    }
+    Close(fd);
+    std::cout << "Folded stacks written to " << foldedName << "\n";
+}
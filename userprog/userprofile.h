@@ -0,0 +1,89 @@
+// userprofile.h
+//	Data structures for a sampling profiler for user programs.
+//
+//	Every so many user instructions, the profiler records the user
+//	program counter, and the return address in R31.  When Nachos
+//	halts, it prints the functions and instructions where most
+//	samples fell, and writes the samples as "folded stacks", one
+//	"caller;callee count" line per call site, for flame graph tools.
+//
+//	Functions are named from the symbol file the test/ Makefile
+//	writes next to each program ("nm -n" output, in "halt.sym" for
+//	"halt.noff").  Without one, raw addresses are reported.
+//
+//	The return address is only a guess at the caller: a function
+//	that has itself made a call has R31 pointing into itself, so
+//	such samples are reported with no caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef USERPROFILE_H
+#define USERPROFILE_H
+
+#include "copyright.h"
+#include "utility.h"
+
+const int DefaultProfileInterval = 100;	// user instructions per sample
+
+// The following class records the samples that fell at one program
+// counter with one return address.
+
+class ProfileSample {
+  public:
+    unsigned int pc;		// where the program was
+    unsigned int ra;		// the return address in R31
+    int count;			// number of samples; 0 if entry unused
+};
+
+// The following class records a function in the program's symbol table.
+
+class ProfileSymbol {
+  public:
+    unsigned int address;	// where the function starts
+    char *name;
+};
+
+// The following class defines the profiler.  Samples are kept in a
+// hash table, keyed by program counter and return address, that
+// is doubled in size as it fills up.
+
+class UserProfiler {
+  public:
+    UserProfiler(int interval);	// sample every "interval" user
+				// instructions
+    ~UserProfiler();
+
+    void LoadSymbols(char *programName);
+				// Read the symbols of the program being
+				// profiled, and name the folded stacks
+				// file after it
+    void Tick() { if (--countdown <= 0) { Sample(); } }
+				// Called after each user instruction
+    void Print();		// Print the hot spots, and write the
+				// folded stacks
+
+  private:
+    int interval;		// user instructions between samples
+    int countdown;		// instructions until the next sample
+    int numSamples;		// samples taken
+
+    ProfileSample *table;	// hash table of samples
+    int tableSize;		// entries in "table"; a power of 2
+    int numEntries;		// entries in use
+
+    ProfileSymbol *symbols;	// the program's functions, by address
+    int numSymbols;
+    char *foldedName;		// file for the folded stacks, or NULL
+
+    void Sample();		// Record the current PC and return address
+    void Record(unsigned int pc, unsigned int ra, int count);
+				// Add "count" samples to an entry
+    int FindSymbol(unsigned int address);
+				// Index of the function holding "address";
+				// -1 if not known
+    void WriteFolded();		// Write the folded stacks file
+};
+
+#endif // USERPROFILE_H
@@ -0,0 +1,99 @@
+// usersem.cc
+//	Routines to manage the semaphores created by user programs.
+//	The semaphores themselves are ordinary kernel Semaphores.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "usersem.h"
+#include "syscall.h"
+
+//----------------------------------------------------------------------
+// UserSemaphoreTable::UserSemaphoreTable
+//	Initialize the table of user semaphores, with none created.
+//----------------------------------------------------------------------
+
+UserSemaphoreTable::UserSemaphoreTable()
+{
+    for (int i = 0; i < MaxUserSemaphores; i++) {
+	semaphores[i] = NULL;
+    }
+}
+
+//----------------------------------------------------------------------
+// UserSemaphoreTable::~UserSemaphoreTable
+//	De-allocate all the user semaphores.
+//----------------------------------------------------------------------
+
+UserSemaphoreTable::~UserSemaphoreTable()
+{
+    for (int i = 0; i < MaxUserSemaphores; i++) {
+	delete semaphores[i];
+    }
+}
+
+//----------------------------------------------------------------------
+// UserSemaphoreTable::Create
+//	Return the id of the semaphore named "key", creating it with
+//	"initialValue" if no program has created it yet.
+//
+// Returns:
+//	the semaphore's id, or EINVAL if "initialValue" is negative, or
+//	ENOSPC if the table is full
+//----------------------------------------------------------------------
+
+int
+UserSemaphoreTable::Create(int key, int initialValue)
+{
+    int id = -1;
+
+    if (initialValue < 0) {
+	return EINVAL;
+    }
+    for (int i = 0; i < MaxUserSemaphores; i++) {
+	if (semaphores[i] != NULL && keys[i] == key) {
+	    return i;			// already exists
+	}
+	if (semaphores[i] == NULL && id < 0) {
+	    id = i;
+	}
+    }
+    if (id < 0) {
+	return ENOSPC;
+    }
+    semaphores[id] = new Semaphore("user semaphore", initialValue);
+    keys[id] = key;
+    return id;
+}
+
+//----------------------------------------------------------------------
+// UserSemaphoreTable::P
+//	Wait on user semaphore "id".
+//----------------------------------------------------------------------
+
+int
+UserSemaphoreTable::P(int id)
+{
+    if (id < 0 || id >= MaxUserSemaphores || semaphores[id] == NULL) {
+	return EINVAL;
+    }
+    semaphores[id]->P();
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// UserSemaphoreTable::V
+//	Signal user semaphore "id".
+//----------------------------------------------------------------------
+
+int
+UserSemaphoreTable::V(int id)
+{
+    if (id < 0 || id >= MaxUserSemaphores || semaphores[id] == NULL) {
+	return EINVAL;
+    }
+    semaphores[id]->V();
+    return 0;
+}
@@ -0,0 +1,40 @@
+// usersem.h
+//	Data structures for semaphores that user programs can use to
+//	coordinate with each other, eg, around a shared memory segment.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef USERSEM_H
+#define USERSEM_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "synch.h"
+
+const int MaxUserSemaphores = 16;	// system-wide
+
+// The following class keeps track of the semaphores created by user
+// programs.  Each is named by an integer "key", so that unrelated
+// programs can find the same semaphore; the kernel hands back a small
+// id to use with P and V.
+
+class UserSemaphoreTable {
+  public:
+    UserSemaphoreTable();	// no semaphores yet
+    ~UserSemaphoreTable();	// de-allocate all the semaphores
+
+    int Create(int key, int initialValue);
+				// Find the semaphore named "key", or
+				// create it; returns its id, or a 
+				// negative error code
+    int P(int id);		// returns 0, or a negative error code
+    int V(int id);		// returns 0, or a negative error code
+
+  private:
+    Semaphore *semaphores[MaxUserSemaphores];	// NULL if unused
+    int keys[MaxUserSemaphores];		// name of each semaphore
+};
+
+#endif // USERSEM_H